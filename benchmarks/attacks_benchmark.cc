@@ -15,9 +15,14 @@
 // You should have received a copy of the GNU General Public License
 // along with this program. If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "benchmark/benchmark.h"
 #include "engine/attacks.h"
+#include "engine/cpu.h"
 #include "engine/types.h"
 
 namespace follychess {
@@ -70,6 +75,79 @@ void BM_LookupAttacksFrom(benchmark::State& state) {
   }
 }
 
+// Looks up attacks with the same magic numbers as MagicSliderAttacks, but
+// from a table that gives every square room for the worst case of its piece
+// (2^9 bishop slots and 2^12 rook slots), as the table was laid out before it
+// was packed.
+class SparseMagicSliderAttacks {
+ public:
+  static constexpr std::size_t kBishopSlotsPerSquare = 1 << 9;
+  static constexpr std::size_t kRookSlotsPerSquare = 1 << 12;
+  static constexpr std::size_t kAttackTableSize =
+      (kBishopSlotsPerSquare + kRookSlotsPerSquare) * kNumSquares;
+
+  static Bitboard GetBishopAttacks(Square square, Bitboard occupied) {
+    const MagicEntry& magic = kSliderAttacks.bishop_magic_squares[square];
+    occupied &= magic.mask;
+    std::size_t index = (magic.magic * occupied.Data()) >> magic.shift;
+    return GetTable()[square * kBishopSlotsPerSquare + index];
+  }
+
+  static Bitboard GetRookAttacks(Square square, Bitboard occupied) {
+    const MagicEntry& magic = kSliderAttacks.rook_magic_squares[square];
+    occupied &= magic.mask;
+    std::size_t index = (magic.magic * occupied.Data()) >> magic.shift;
+    return GetTable()[kBishopSlotsPerSquare * kNumSquares +
+                      square * kRookSlotsPerSquare + index];
+  }
+
+ private:
+  static const std::vector<Bitboard>& GetTable() {
+    static const std::vector<Bitboard> kTable = MakeTable();
+    return kTable;
+  }
+
+  static std::vector<Bitboard> MakeTable() {
+    std::vector<Bitboard> table(kAttackTableSize);
+    for (int square = kFirstSquare; square < kNumSquares; ++square) {
+      const MagicEntry& bishop = kSliderAttacks.bishop_magic_squares[square];
+      std::copy_n(&kSliderAttacks.attacks[bishop.attack_table_index],
+                  std::size_t{1} << (64 - bishop.shift),
+                  &table[square * kBishopSlotsPerSquare]);
+
+      const MagicEntry& rook = kSliderAttacks.rook_magic_squares[square];
+      std::copy_n(&kSliderAttacks.attacks[rook.attack_table_index],
+                  std::size_t{1} << (64 - rook.shift),
+                  &table[kBishopSlotsPerSquare * kNumSquares +
+                         square * kRookSlotsPerSquare]);
+    }
+    return table;
+  }
+};
+
+void SetTableSize(benchmark::State& state, const std::size_t slots) {
+  state.counters["table_kib"] =
+      static_cast<double>(slots * sizeof(Bitboard)) / 1024;
+}
+
+template <Piece Piece>
+void BM_LookupAttacksFromSparseMagicTables(benchmark::State& state) {
+  int square = 0;
+  std::vector<Bitboard> occupancies = GetRandomOccupancies();
+  int occupancy_index = 0;
+
+  for (auto _ : state) {
+    Bitboard occupied = occupancies[occupancy_index % occupancies.size()];
+    benchmark::DoNotOptimize(
+        GenerateAttacks<Piece, SparseMagicSliderAttacks>(
+            static_cast<Square>(square % kNumSquares), occupied));
+
+    ++square;
+    ++occupancy_index;
+  }
+  SetTableSize(state, SparseMagicSliderAttacks::kAttackTableSize);
+}
+
 template <Piece Piece>
 void BM_LookupAttacksFromMagicTables(benchmark::State& state) {
   int square = 0;
@@ -84,6 +162,28 @@ void BM_LookupAttacksFromMagicTables(benchmark::State& state) {
     ++square;
     ++occupancy_index;
   }
+  SetTableSize(state, SlidingAttackTables::kAttackTableSize);
+}
+
+template <Piece Piece>
+void BM_LookupAttacksFromPextTables(benchmark::State& state) {
+  if (!IsSupported(Isa::kBmi2)) {
+    state.SkipWithError("The CPU does not support BMI2.");
+    return;
+  }
+  int square = 0;
+  std::vector<Bitboard> occupancies = GetRandomOccupancies();
+  int occupancy_index = 0;
+
+  for (auto _ : state) {
+    Bitboard occupied = occupancies[occupancy_index % occupancies.size()];
+    benchmark::DoNotOptimize(GenerateAttacks<Piece, PextSliderAttacks>(
+        static_cast<Square>(square % kNumSquares), occupied));
+
+    ++square;
+    ++occupancy_index;
+  }
+  SetTableSize(state, SlidingAttackTables::kAttackTableSize);
 }
 
 // Naively generate attacks on the fly:
@@ -111,6 +211,16 @@ BENCHMARK(BM_LookupAttacksFromMagicTables<kBishop>);
 BENCHMARK(BM_LookupAttacksFromMagicTables<kRook>);
 BENCHMARK(BM_LookupAttacksFromMagicTables<kQueen>);
 
+// Use PEXT to lookup precomputed attacks:
+BENCHMARK(BM_LookupAttacksFromPextTables<kBishop>);
+BENCHMARK(BM_LookupAttacksFromPextTables<kRook>);
+BENCHMARK(BM_LookupAttacksFromPextTables<kQueen>);
+
+// Use magic bitboards with one worst-case sized table per square:
+BENCHMARK(BM_LookupAttacksFromSparseMagicTables<kBishop>);
+BENCHMARK(BM_LookupAttacksFromSparseMagicTables<kRook>);
+BENCHMARK(BM_LookupAttacksFromSparseMagicTables<kQueen>);
+
 }  // namespace
 }  // namespace follychess
 
@@ -0,0 +1,179 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "benchmark/benchmark.h"
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/move_list.h"
+#include "engine/position.h"
+#include "engine/scoped_move.h"
+#include "search/evaluation.h"
+#include "search/nnue.h"
+#include "search/nnue_testing.h"
+#include "search/phase.h"
+
+namespace follychess {
+namespace {
+
+constexpr std::array<std::string_view, 3> kFens = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+// Returns the positions after each legal move of kFens.
+std::vector<Position> MakePositions() {
+  std::vector<Position> positions;
+  for (std::string_view fen : kFens) {
+    auto position = Position::FromFen(fen);
+    CHECK_EQ(position.error_or(""), "");
+    for (const Move move : GenerateLegalMoves(*position)) {
+      ScopedMove scoped_move(move, *position);
+      positions.push_back(*position);
+    }
+  }
+  return positions;
+}
+
+void SetEvalsPerSecond(benchmark::State& state, const std::size_t evals) {
+  state.counters["evals_per_second"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * evals),
+      benchmark::Counter::kIsRate);
+}
+
+void BM_Handcrafted(benchmark::State& state) {
+  const std::vector<Position> positions = MakePositions();
+  std::vector<EvaluationAccumulator> accumulators;
+  for (const Position& position : positions) {
+    accumulators.emplace_back(position);
+  }
+  PawnHashTable pawn_hash_table;
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      benchmark::DoNotOptimize(
+          Evaluate(positions[i], accumulators[i], pawn_hash_table));
+    }
+  }
+  SetEvalsPerSecond(state, positions.size());
+}
+
+BENCHMARK(BM_Handcrafted);
+
+// Returns the positions two plies after each position of kFens.
+std::vector<Position> MakeManyPositions() {
+  std::vector<Position> positions;
+  for (Position position : MakePositions()) {
+    for (const Move move : GenerateLegalMoves(position)) {
+      ScopedMove scoped_move(move, position);
+      positions.push_back(position);
+    }
+  }
+  return positions;
+}
+
+// Evaluates each position from scratch, as offline tooling did before
+// EvaluateBatch().
+void BM_EvaluateLoop(benchmark::State& state) {
+  const std::vector<Position> positions = MakeManyPositions();
+  std::vector<int> scores(positions.size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      scores[i] = Evaluate(positions[i], CalculatePhase(positions[i]));
+    }
+    benchmark::DoNotOptimize(scores.data());
+  }
+  SetEvalsPerSecond(state, positions.size());
+}
+
+BENCHMARK(BM_EvaluateLoop)->UseRealTime();
+
+void BM_EvaluateBatch(benchmark::State& state) {
+  const int threads = state.range(0);
+  const std::vector<Position> positions = MakeManyPositions();
+  std::vector<int> scores(positions.size());
+
+  for (auto _ : state) {
+    EvaluateBatch(positions, scores, threads);
+    benchmark::DoNotOptimize(scores.data());
+  }
+  SetEvalsPerSecond(state, positions.size());
+}
+
+BENCHMARK(BM_EvaluateBatch)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+// Runs the dense layers of the network with the given kernel. The
+// accumulators are computed up front, as the search updates them
+// incrementally.
+void BM_Nnue(benchmark::State& state, const nnue::Kernel kernel) {
+  if (!nnue::IsSupported(kernel)) {
+    state.SkipWithError("The CPU does not support this kernel.");
+    return;
+  }
+  const nnue::Network network = nnue::MakeRandomNetwork();
+  const std::vector<Position> positions = MakePositions();
+  std::vector<nnue::Accumulator> accumulators;
+  for (const Position& position : positions) {
+    accumulators.emplace_back(network, position);
+  }
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      benchmark::DoNotOptimize(
+          nnue::Evaluate(network, positions[i], accumulators[i], kernel));
+    }
+  }
+  SetEvalsPerSecond(state, positions.size());
+  state.SetLabel(std::string(nnue::ToString(kernel)));
+}
+
+BENCHMARK_CAPTURE(BM_Nnue, Scalar, nnue::Kernel::kScalar);
+BENCHMARK_CAPTURE(BM_Nnue, Sse41, nnue::Kernel::kSse41);
+BENCHMARK_CAPTURE(BM_Nnue, Avx2, nnue::Kernel::kAvx2);
+
+// Updates the accumulator for each legal move, as the search does before
+// making a move.
+void BM_NnueAccumulatorUpdate(benchmark::State& state) {
+  const nnue::Network network = nnue::MakeRandomNetwork();
+  auto position = Position::FromFen(kFens[1]);
+  CHECK_EQ(position.error_or(""), "");
+  const nnue::Accumulator accumulator(network, *position);
+  const MoveList moves = GenerateLegalMoves(*position);
+
+  for (auto _ : state) {
+    for (const Move move : moves) {
+      benchmark::DoNotOptimize(accumulator.After(network, *position, move));
+    }
+  }
+  state.counters["updates_per_second"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * moves.size()),
+      benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_NnueAccumulatorUpdate);
+
+}  // namespace
+}  // namespace follychess
+
+BENCHMARK_MAIN();
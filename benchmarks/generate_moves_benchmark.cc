@@ -15,9 +15,15 @@
 // You should have received a copy of the GNU General Public License
 // along with this program. If not, see <https://www.gnu.org/licenses/>.
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
 #include "benchmark/benchmark.h"
 #include "engine/attacks.h"
 #include "engine/move_generator.h"
+#include "engine/move_list.h"
 #include "engine/position.h"
 #include "engine/scoped_move.h"
 #include "engine/types.h"
@@ -25,6 +31,44 @@
 namespace follychess {
 namespace {
 
+// The number of heap allocations made so far, as counted by the replacement
+// `operator new` below.
+std::atomic<std::int64_t> allocations = 0;
+
+// Reports the number of heap allocations per iteration. This should be zero,
+// since moves are generated into fixed-capacity lists.
+class AllocationCounter {
+ public:
+  explicit AllocationCounter(benchmark::State& state)
+      : state_(state), start_(allocations.load(std::memory_order_relaxed)) {}
+
+  ~AllocationCounter() {
+    state_.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(allocations.load(std::memory_order_relaxed) -
+                            start_),
+        benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  benchmark::State& state_;
+  const std::int64_t start_;
+};
+
+template <class... Args>
+void BM_GenerateLegalMoves(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+
+  auto position_or_error = Position::FromFen(std::get<0>(args_tuple));
+  CHECK_EQ(position_or_error.error_or(""), "");
+  Position position = position_or_error.value();
+
+  AllocationCounter allocation_counter(state);
+  for (auto _ : state) {
+    MoveList moves = GenerateLegalMoves(position);
+    benchmark::DoNotOptimize(moves);
+  }
+}
+
 template <class... Args>
 void BM_GenerateLegalMovesWithCopy(benchmark::State& state, Args&&... args) {
   auto args_tuple = std::make_tuple(std::move(args)...);
@@ -33,8 +77,9 @@ void BM_GenerateLegalMovesWithCopy(benchmark::State& state, Args&&... args) {
   CHECK_EQ(position_or_error.error_or(""), "");
   Position position = position_or_error.value();
 
+  AllocationCounter allocation_counter(state);
   for (auto _ : state) {
-    std::vector<Move> moves;
+    MoveList moves;
     for (Move move : GenerateLegalMoves(position)) {
       Position new_position = position;
       new_position.Do(move);
@@ -53,8 +98,9 @@ void BM_GenerateLegalMovesWithScopedMove(benchmark::State& state,
   CHECK_EQ(position_or_error.error_or(""), "");
   Position position = position_or_error.value();
 
+  AllocationCounter allocation_counter(state);
   for (auto _ : state) {
-    std::vector<Move> moves;
+    MoveList moves;
     for (Move move : GenerateLegalMoves(position)) {
       ScopedMove scoped_move(move, position);
       moves.push_back(move);
@@ -75,6 +121,11 @@ constexpr auto kPosition3 =  //
 constexpr auto kPosition5 =
     R"(rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8)";
 
+BENCHMARK_CAPTURE(BM_GenerateLegalMoves, Starting, kStarting);
+BENCHMARK_CAPTURE(BM_GenerateLegalMoves, Position2, kPosition2);
+BENCHMARK_CAPTURE(BM_GenerateLegalMoves, Position3, kPosition3);
+BENCHMARK_CAPTURE(BM_GenerateLegalMoves, Position5, kPosition5);
+
 BENCHMARK_CAPTURE(BM_GenerateLegalMovesWithCopy, kStarting, kStarting);
 BENCHMARK_CAPTURE(BM_GenerateLegalMovesWithCopy, Position2, kPosition2);
 BENCHMARK_CAPTURE(BM_GenerateLegalMovesWithCopy, Position3, kPosition3);
@@ -88,4 +139,18 @@ BENCHMARK_CAPTURE(BM_GenerateLegalMovesWithScopedMove, kPosition5, kPosition5);
 }  // namespace
 }  // namespace follychess
 
+void* operator new(const std::size_t size) {
+  follychess::allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
 BENCHMARK_MAIN();
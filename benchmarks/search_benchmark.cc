@@ -15,7 +15,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program. If not, see <https://www.gnu.org/licenses/>.
 
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <string_view>
+
 #include "benchmark/benchmark.h"
+#include "engine/game.h"
 #include "engine/position.h"
 #include "search/search.h"
 
@@ -31,9 +37,19 @@ void BM_Search(benchmark::State& state, Args&&... args) {
   CHECK_EQ(position.error_or(""), "");
   Game game(position.value());
 
+  SearchInfo last_info{};
   for (auto _ : state) {
-    (void)Search(game, SearchOptions().SetDepth(depth));
+    (void)Search(game, SearchOptions().SetDepth(depth).SetInfoObserver(
+                           [&](const SearchInfo& info) { last_info = info; }));
   }
+
+  state.counters["nodes"] = static_cast<double>(last_info.nodes);
+  state.counters["tthits"] = static_cast<double>(
+      last_info.transposition_table_metrics.hits);
+  state.counters["tthitrate"] = last_info.transposition_table_metrics.hit_rate;
+  state.counters["hashfull"] = last_info.hash_full;
+  state.counters["pawnhitrate"] = last_info.pawn_hash_table_metrics.hit_rate;
+  state.counters["evalhitrate"] = last_info.eval_cache_metrics.hit_rate;
 }
 
 BENCHMARK_CAPTURE(  //
@@ -49,6 +65,149 @@ BENCHMARK_CAPTURE(BM_Search, HighTransposition,
                   R"(8/8/7r/K7/1R6/7k/8/N7 w - - 0 1)")
     ->DenseRange(/* start = */ 1, /* limit = */ 8, /* step = */ 1);
 
+constexpr std::string_view kStarting =
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr std::string_view kKiwipete =
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+constexpr std::string_view kPosition3 =
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1";
+constexpr std::string_view kHighTransposition =
+    "8/8/7r/K7/1R6/7k/8/N7 w - - 0 1";
+
+// A search setup that is compared against the default one on a position.
+struct Variant {
+  std::string_view name;
+  std::string_view fen;
+  int min_depth;
+  int max_depth;
+
+  // Changes the default options, e.g., to turn off one of the SearchFeatures.
+  void (*configure)(SearchOptions& options) = nullptr;
+
+  Game::Mode mode = Game::Mode::kMakeUnmake;
+  std::size_t hash_size_mb = 256;
+};
+
+void NoWindows(SearchOptions& options) {
+  options.SetFeatures(
+      {.aspiration_windows = false, .principal_variation_search = false});
+}
+
+void NoLateMoves(SearchOptions& options) {
+  options.SetFeatures(
+      {.late_move_reductions = false, .late_move_pruning = false});
+}
+
+void NoSeePruning(SearchOptions& options) {
+  options.SetFeatures({.see_pruning = false});
+}
+
+void NoPrefetch(SearchOptions& options) {
+  options.SetFeatures({.prefetch = false});
+}
+
+void NoEvalCache(SearchOptions& options) { options.SetEvalCacheSize(0); }
+
+// Each position has a single `Default` entry, and every other entry of the
+// position turns off one technique, so it is compared against that baseline.
+const Variant kVariants[] = {
+    {"Default/Starting", kStarting, 5, 7},
+    {"FullWindow/Starting", kStarting, 5, 7, NoWindows},
+    {"NoLateMoves/Starting", kStarting, 5, 7, NoLateMoves},
+
+    {"Default/Kiwipete", kKiwipete, 4, 6},
+    {"NoLateMoves/Kiwipete", kKiwipete, 4, 6, NoLateMoves},
+    {"CopyMake/Kiwipete", kKiwipete, 4, 6, nullptr, Game::Mode::kCopyMake},
+
+    {"Default/Position3", kPosition3, 6, 8},
+    {"FullWindow/Position3", kPosition3, 6, 8, NoWindows},
+    {"NoLateMoves/Position3", kPosition3, 6, 8, NoLateMoves},
+    {"NoSeePruning/Position3", kPosition3, 6, 8, NoSeePruning},
+
+    {"Default/HighTransposition", kHighTransposition, 6, 8},
+    {"FullWindow/HighTransposition", kHighTransposition, 6, 8, NoWindows},
+    {"NoEvalCache/HighTransposition", kHighTransposition, 6, 8, NoEvalCache},
+
+    // Prefetching only pays off with a table that is much larger than the
+    // caches, so it is compared against its own baseline with such a table.
+    {"LargeHash/Kiwipete", kKiwipete, 4, 6, nullptr, Game::Mode::kMakeUnmake,
+     /*hash_size_mb=*/1024},
+    {"LargeHashNoPrefetch/Kiwipete", kKiwipete, 4, 6, NoPrefetch,
+     Game::Mode::kMakeUnmake, /*hash_size_mb=*/1024},
+};
+
+// Searches the position of `variant` to a fixed depth with a cleared searcher,
+// and reports the nodes visited and the nodes per second of the final
+// iteration.
+void BM_Variant(benchmark::State& state, const Variant& variant) {
+  const int depth = state.range(0);
+  auto position = Position::FromFen(variant.fen);
+  CHECK_EQ(position.error_or(""), "");
+  Game game(position.value(), variant.mode);
+
+  Searcher searcher(variant.hash_size_mb);
+  SearchInfo last_info{};
+  SearchOptions options = SearchOptions().SetDepth(depth).SetInfoObserver(
+      [&](const SearchInfo& info) { last_info = info; });
+  if (variant.configure != nullptr) {
+    variant.configure(options);
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    searcher.Clear();
+    state.ResumeTiming();
+    (void)searcher.Search(game, options);
+  }
+
+  state.counters["nodes"] = static_cast<double>(last_info.nodes);
+  state.counters["nps"] = static_cast<double>(last_info.node_per_second);
+  state.counters["evalhitrate"] = last_info.eval_cache_metrics.hit_rate;
+}
+
+[[maybe_unused]] const bool kVariantsRegistered = [] {
+  for (const Variant& variant : kVariants) {
+    benchmark::RegisterBenchmark(std::format("BM_Variant/{}", variant.name),
+                                 BM_Variant, variant)
+        ->DenseRange(variant.min_depth, variant.max_depth, /*step=*/1);
+  }
+  return true;
+}();
+
+// Plays the first moves of a game, searching each position either from scratch
+// or with a searcher that is kept for the whole game.
+void BM_PlayGame(benchmark::State& state, const bool persistent) {
+  constexpr int kNumPlies = 8;
+  const int depth = state.range(0);
+
+  // Only the persistent games need a searcher of their own. It is allocated
+  // once and reset outside of the timed region, as in BM_Variant.
+  std::optional<Searcher> searcher;
+  if (persistent) {
+    searcher.emplace();
+  }
+
+  for (auto _ : state) {
+    if (searcher) {
+      state.PauseTiming();
+      searcher->Clear();
+      state.ResumeTiming();
+    }
+    Game game;
+    for (int ply = 0; ply < kNumPlies; ++ply) {
+      const SearchOptions options = SearchOptions().SetDepth(depth);
+      const Move move =
+          searcher ? searcher->Search(game, options) : Search(game, options);
+      game.Do(move);
+    }
+  }
+}
+
+BENCHMARK_CAPTURE(BM_PlayGame, FreshSearch, /*persistent=*/false)
+    ->DenseRange(/* start = */ 1, /* limit = */ 5, /* step = */ 1);
+
+BENCHMARK_CAPTURE(BM_PlayGame, PersistentSearcher, /*persistent=*/true)
+    ->DenseRange(/* start = */ 1, /* limit = */ 5, /* step = */ 1);
+
 }  // namespace
 }  // namespace follychess
 
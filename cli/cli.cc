@@ -19,6 +19,7 @@
 
 #include "absl/strings/str_join.h"
 #include "command.h"
+#include "commands/cpu_command.h"
 #include "commands/display.h"
 #include "commands/isready_command.h"
 #include "commands/perft_command.h"
@@ -39,12 +40,15 @@ CommandDispatcher MakeCommandDispatcher(CommandState& state) {
 
   dispatcher.Add("perft", std::make_unique<PerftCommand>(state));
 
+  dispatcher.Add("cpu", std::make_unique<Cpu>(state));
   dispatcher.Add("d", std::make_unique<Display>(state));
   dispatcher.Add("isready", std::make_unique<IsReady>(state));
   dispatcher.Add("uci", std::make_unique<Uci>(state));
   dispatcher.Add("ucinewgame", std::make_unique<UciNewGame>(state));
   dispatcher.Add("setoption", std::make_unique<SetOption>(state));
   dispatcher.Add("go", std::make_unique<Go>(state));
+  dispatcher.Add("stop", std::make_unique<Stop>(state));
+  dispatcher.Add("ponderhit", std::make_unique<PonderHit>(state));
 
   return dispatcher;
 }
@@ -20,12 +20,26 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <thread>
+
+#include "engine/cpu.h"
+#include "search/nnue.h"
+#include "search/nnue_testing.h"
+
 namespace follychess {
 namespace {
 
 using ::testing::Eq;
+using ::testing::Gt;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
+using ::testing::IsNull;
+using ::testing::Lt;
+using ::testing::NotNull;
 using ::testing::StartsWith;
 
 std::size_t CountLeadingSpaces(std::string_view input) {
@@ -79,9 +93,16 @@ class CliTest : public ::testing::Test {
     std::cout.rdbuf(stream_.rdbuf());
   }
 
-  ~CliTest() override { std::cout.rdbuf(old_stdout_buffer_); }
+  ~CliTest() override {
+    state_.searcher.Stop();
+    state_.searcher.Wait();
+    std::cout.rdbuf(old_stdout_buffer_);
+  }
 
+  // Returns the output so far. Waits for the background search to end, so
+  // that its output is complete.
   std::string GetOutput() {
+    state_.searcher.Wait();
     std::string val = stream_.str();
     stream_.str("");
     return val;
@@ -107,9 +128,103 @@ TEST_F(CliTest, Uci) {
     id author Aryan Naraghi
 
     option name LogDirectory type string default <empty>
+    option name Threads type spin default 1 min 1 max 512
+    option name Hash type spin default 256 min 1 max 65536
+    option name Clear Hash type button
+    option name EvalCache type spin default 1 min 0 max 1024
+    option name EvalFile type string default <empty>
     uciok)")));
 }
 
+TEST_F(CliTest, SetThreads) {
+  ASSERT_THAT(
+      Run({"setoption", "name", "Threads", "value", "4"}).error_or(""),
+      IsEmpty());
+  EXPECT_THAT(state_.threads, Eq(4));
+
+  EXPECT_THAT(
+      Run({"setoption", "name", "Threads", "value", "0"}).error_or(""),
+      HasSubstr("Invalid Threads value: 0"));
+  EXPECT_THAT(
+      Run({"setoption", "name", "Threads", "value", "x"}).error_or(""),
+      HasSubstr("Invalid Threads value: x"));
+  EXPECT_THAT(state_.threads, Eq(4));
+}
+
+TEST_F(CliTest, SetHash) {
+  const TranspositionTable& table = state_.searcher.GetTranspositionTable();
+  ASSERT_THAT(Run({"setoption", "name", "Hash", "value", "1"}).error_or(""),
+              IsEmpty());
+  EXPECT_THAT(table.size(), Eq(1 << 14));
+
+  EXPECT_THAT(Run({"setoption", "name", "Hash", "value", "0"}).error_or(""),
+              HasSubstr("Invalid Hash value: 0"));
+  EXPECT_THAT(table.size(), Eq(1 << 14));
+}
+
+TEST_F(CliTest, SetEvalCache) {
+  ASSERT_THAT(
+      Run({"setoption", "name", "EvalCache", "value", "0"}).error_or(""),
+      IsEmpty());
+  EXPECT_THAT(state_.eval_cache_size_mb, Eq(0));
+
+  ASSERT_THAT(
+      Run({"setoption", "name", "EvalCache", "value", "16"}).error_or(""),
+      IsEmpty());
+  EXPECT_THAT(state_.eval_cache_size_mb, Eq(16));
+
+  EXPECT_THAT(
+      Run({"setoption", "name", "EvalCache", "value", "-1"}).error_or(""),
+      HasSubstr("Invalid EvalCache value: -1"));
+  EXPECT_THAT(state_.eval_cache_size_mb, Eq(16));
+}
+
+TEST_F(CliTest, SetEvalFile) {
+  const std::string path = (std::filesystem::path(::testing::TempDir()) /
+                            "set_eval_file.nnue")
+                               .string();
+  ASSERT_THAT(nnue::MakeRandomNetwork().Save(path).error_or(""), IsEmpty());
+
+  ASSERT_THAT(Run({"setoption", "name", "EvalFile", "value", path}).error_or(""),
+              IsEmpty());
+  EXPECT_THAT(state_.network, NotNull());
+  ASSERT_THAT(Run({"go", "depth", "3"}).error_or(""), IsEmpty());
+  state_.searcher.Wait();
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove"));
+
+  EXPECT_THAT(Run({"setoption", "name", "EvalFile", "value", "missing.nnue"})
+                  .error_or(""),
+              HasSubstr("Could not open network file: missing.nnue"));
+  EXPECT_THAT(state_.network, NotNull());
+
+  ASSERT_THAT(
+      Run({"setoption", "name", "EvalFile", "value", "<empty>"}).error_or(""),
+      IsEmpty());
+  EXPECT_THAT(state_.network, IsNull());
+}
+
+TEST_F(CliTest, ClearHash) {
+  const TranspositionTable& table = state_.searcher.GetTranspositionTable();
+  ASSERT_THAT(Run({"setoption", "name", "Hash", "value", "1"}).error_or(""),
+              IsEmpty());
+  ASSERT_THAT(Run({"go", "depth", "3"}).error_or(""), IsEmpty());
+  state_.searcher.Wait();
+  EXPECT_THAT(table.GetHashFull(), Gt(0));
+
+  ASSERT_THAT(Run({"setoption", "name", "Clear", "Hash"}).error_or(""),
+              IsEmpty());
+  EXPECT_THAT(table.GetHashFull(), Eq(0));
+}
+
+TEST_F(CliTest, SetOptionErrors) {
+  EXPECT_THAT(Run({"setoption", "name"}).error_or(""),
+              HasSubstr("Invalid setoption command"));
+  EXPECT_THAT(Run({"setoption", "name", "Hash", "value"}).error_or(""),
+              HasSubstr("Invalid setoption command"));
+  EXPECT_THAT(Run({"setoption", "name", "Foo", "value", "1"}).error_or(""),
+              HasSubstr("Invalid option: Foo"));
+}
+
 TEST_F(CliTest, UciNewGame) {
   ASSERT_THAT(Run({"position", "startpos", "moves", "d2d4"}).error_or(""),
               IsEmpty());
@@ -121,6 +236,18 @@ TEST_F(CliTest, UciNewGame) {
   EXPECT_THAT(GetOutput(), HasSubstr("w KQkq - 0 1"));
 }
 
+TEST_F(CliTest, UciNewGameClearsSearchState) {
+  const TranspositionTable& table = state_.searcher.GetTranspositionTable();
+  ASSERT_THAT(Run({"setoption", "name", "Hash", "value", "1"}).error_or(""),
+              IsEmpty());
+  ASSERT_THAT(Run({"go", "depth", "4"}).error_or(""), IsEmpty());
+  state_.searcher.Wait();
+  EXPECT_THAT(table.GetHashFull(), Gt(0));
+
+  ASSERT_THAT(Run({"ucinewgame"}).error_or(""), IsEmpty());
+  EXPECT_THAT(table.GetHashFull(), Eq(0));
+}
+
 TEST_F(CliTest, Display) {
   ASSERT_THAT(Run({"d"}).error_or(""), IsEmpty());
 
@@ -139,6 +266,22 @@ TEST_F(CliTest, Display) {
     )")));
 }
 
+TEST_F(CliTest, Cpu) {
+  ASSERT_THAT(Run({"cpu"}).error_or(""), IsEmpty());
+
+  EXPECT_THAT(
+      GetOutput(),
+      Eq(std::format("cpu: {}\n"
+                     "build: {}\n"
+                     "isa: {}\n"
+                     "slider attacks: {}\n"
+                     "nnue kernel: {}\n",
+                     ToString(GetCpuFeatures()), ToString(kBuildCpuFeatures),
+                     ToString(GetBestIsa()),
+                     GetSliderAttacksName(GetBestIsa()),
+                     nnue::ToString(nnue::GetBestKernel()))));
+}
+
 TEST_F(CliTest, IsReady) {
   ASSERT_THAT(Run({"isready"}).error_or(""), IsEmpty());
 
@@ -157,6 +300,8 @@ TEST_F(CliTest, Go) {
                   Not(HasSubstr("info depth 6")),  //
                   HasSubstr("bestmove d2d4")));
 
+  // The transposition table is kept across searches, so the shallower search
+  // reuses the result of the previous one.
   ASSERT_THAT(
       Run({"go", "wtime", "1000", "btime", "1000", "depth", "2"}).error_or(""),
       IsEmpty());
@@ -164,7 +309,73 @@ TEST_F(CliTest, Go) {
                                HasSubstr("info depth 1"),       //
                                HasSubstr("info depth 2"),       //
                                Not(HasSubstr("info depth 3")),  //
-                               HasSubstr("bestmove e2e4")));
+                               HasSubstr("bestmove d2d4")));
+
+  ASSERT_THAT(Run({"setoption", "name", "Clear", "Hash"}).error_or(""),
+              IsEmpty());
+  ASSERT_THAT(
+      Run({"go", "wtime", "1000", "btime", "1000", "depth", "2"}).error_or(""),
+      IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove e2e4"));
+}
+
+TEST_F(CliTest, GoWithTimeLimits) {
+  ASSERT_THAT(Run({"setoption", "name", "Hash", "value", "16"}).error_or(""),
+              IsEmpty());
+
+  ASSERT_THAT(Run({"go", "movetime", "50"}).error_or(""), IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+
+  ASSERT_THAT(Run({"go", "wtime", "2000", "btime", "2000", "winc", "10",
+                   "binc", "10", "movestogo", "20"})
+                  .error_or(""),
+              IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+
+  ASSERT_THAT(Run({"go", "nodes", "1000"}).error_or(""), IsEmpty());
+  EXPECT_THAT(GetOutput(), HasSubstr("bestmove "));
+}
+
+TEST_F(CliTest, GoInfiniteUntilStop) {
+  ASSERT_THAT(Run({"go", "infinite"}).error_or(""), IsEmpty());
+  ASSERT_THAT(Run({"isready"}).error_or(""), IsEmpty());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_THAT(Run({"stop"}).error_or(""), IsEmpty());
+
+  // `isready` is answered while the search is running.
+  const std::string output = GetOutput();
+  EXPECT_THAT(output, HasSubstr("bestmove "));
+  EXPECT_THAT(output.find("readyok"), Lt(output.find("bestmove ")));
+}
+
+TEST_F(CliTest, GoPonder) {
+  ASSERT_THAT(Run({"go", "ponder", "movetime", "10"}).error_or(""),
+              IsEmpty());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // The time limit only applies once the opponent plays the expected move.
+  ASSERT_THAT(Run({"isready"}).error_or(""), IsEmpty());
+  ASSERT_THAT(Run({"ponderhit"}).error_or(""), IsEmpty());
+
+  const std::string output = GetOutput();
+  EXPECT_THAT(output, HasSubstr("bestmove "));
+  EXPECT_THAT(output.find("readyok"), Lt(output.find("bestmove ")));
+}
+
+TEST_F(CliTest, StopWithoutSearch) {
+  EXPECT_THAT(Run({"stop"}).error_or(""), IsEmpty());
+  EXPECT_THAT(GetOutput(), IsEmpty());
+}
+
+TEST_F(CliTest, GoErrors) {
+  EXPECT_THAT(Run({"go", "depth"}).error_or(""),
+              HasSubstr("Missing depth value"));
+  EXPECT_THAT(Run({"go", "depth", "x"}).error_or(""),
+              HasSubstr("Invalid depth value: x"));
+  EXPECT_THAT(Run({"go", "depth", "0"}).error_or(""),
+              HasSubstr("Invalid depth value: 0"));
+  EXPECT_THAT(Run({"go", "foo", "1"}).error_or(""),
+              HasSubstr("Invalid go parameter: foo"));
 }
 
 }  // namespace
@@ -18,6 +18,7 @@
 #include "command.h"
 
 #include <format>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -33,6 +34,7 @@ struct overloaded : Ts... {
 }  // namespace
 
 void Printer::PrintStdIn(std::string_view in) const {
+  std::lock_guard lock(mutex_);
   if (log_file_) {
     *log_file_ << in << std::endl;
   }
@@ -43,6 +45,7 @@ std::expected<void, std::string> Printer::SetLogFile(std::string filename) {
   if (!log_file->is_open()) {
     return std::unexpected(std::format("Could not open file: {}", filename));
   }
+  std::lock_guard lock(mutex_);
   log_file_ = std::move(log_file);
   return {};
 }
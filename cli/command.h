@@ -18,25 +18,33 @@
 #ifndef FOLLYCHESS_CLI_COMMAND_H_
 #define FOLLYCHESS_CLI_COMMAND_H_
 
+#include <cstddef>
 #include <expected>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
 
 #include "engine/game.h"
+#include "search/nnue.h"
+#include "search/search.h"
 
 namespace follychess {
 
+// Prints command output. This is safe to call from multiple threads, since
+// searches print from a background thread.
 class Printer {
  public:
   template <typename... Args>
   void Println(std::ostream &stream, std::format_string<Args...> fmt = "",
                Args &&...args) const {
     const std::string value = std::format(fmt, std::forward<Args>(args)...);
+    std::lock_guard lock(mutex_);
     stream << value << std::endl;
     if (log_file_) {
       *log_file_ << value << std::endl;
@@ -48,12 +56,28 @@ class Printer {
   std::expected<void, std::string> SetLogFile(std::string filename);
 
  private:
+  mutable std::mutex mutex_;
   std::unique_ptr<std::ofstream> log_file_;
 };
 
 struct CommandState {
   Game game;
   Printer printer;
+
+  // The number of search threads, as set by the `Threads` option.
+  int threads = 1;
+
+  // The memory limit of each search thread's evaluation cache, as set by the
+  // `EvalCache` option.
+  std::size_t eval_cache_size_mb = 1;
+
+  // The network loaded by the `EvalFile` option. If not set, the handcrafted
+  // evaluation is used.
+  std::shared_ptr<const nnue::Network> network;
+
+  // Kept across `go` commands and reset by `ucinewgame`. Searches run in the
+  // background, so that commands such as `stop` are handled while searching.
+  Searcher searcher;
 };
 
 class Command {
@@ -0,0 +1,57 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_CLI_COMMANDS_CPU_COMMAND_H_
+#define FOLLYCHESS_CLI_COMMANDS_CPU_COMMAND_H_
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cli/command.h"
+#include "engine/cpu.h"
+#include "search/nnue.h"
+
+namespace follychess {
+
+// Prints the instruction sets of the CPU and of the build, and the code paths
+// that the engine uses on this CPU.
+class Cpu : public Command {
+ public:
+  explicit Cpu(CommandState& state) : state_(state) {}
+
+  std::expected<void, std::string> Run(
+      std::vector<std::string_view> args) override {
+    state_.printer.Println(std::cout, "cpu: {}", ToString(GetCpuFeatures()));
+    state_.printer.Println(std::cout, "build: {}",
+                           ToString(kBuildCpuFeatures));
+    state_.printer.Println(std::cout, "isa: {}", ToString(GetBestIsa()));
+    state_.printer.Println(std::cout, "slider attacks: {}",
+                           GetSliderAttacksName(GetBestIsa()));
+    state_.printer.Println(std::cout, "nnue kernel: {}",
+                           nnue::ToString(nnue::GetBestKernel()));
+    return {};
+  }
+
+ private:
+  CommandState& state_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_CLI_COMMANDS_CPU_COMMAND_H_
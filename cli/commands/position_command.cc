@@ -21,12 +21,13 @@
 
 #include "engine/move.h"
 #include "engine/move_generator.h"
+#include "engine/move_list.h"
 
 namespace follychess {
 namespace {
 
 std::optional<Move> FindMove(std::string_view uci_move,
-                             const std::vector<Move> &moves) {
+                             const MoveList &moves) {
   for (const Move &move : moves) {
     if (std::format("{}", move) == uci_move) {
       return move;
@@ -46,7 +47,7 @@ std::expected<void, std::string> ApplyMoves(
   }
 
   for (int i = 1; i < uci_moves.size(); ++i) {
-    std::vector<Move> moves = GenerateLegalMoves(game.GetPosition());
+    MoveList moves = GenerateLegalMoves(game.GetPosition());
 
     std::optional<Move> move = FindMove(uci_moves[i], moves);
     if (!move) {
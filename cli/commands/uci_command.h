@@ -18,8 +18,16 @@
 #ifndef FOLLYCHESS_CLI_COMMANDS_UCI_COMMAND_H_
 #define FOLLYCHESS_CLI_COMMANDS_UCI_COMMAND_H_
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <string>
 
+#include "absl/strings/str_join.h"
 #include "cli/command.h"
 #include "cli/options.h"
 #include "search/search.h"
@@ -55,6 +63,7 @@ class UciNewGame : public Command {
   std::expected<void, std::string> Run(
       std::vector<std::string_view> args) override {
     state_.game = Game();
+    state_.searcher.Clear(state_.threads);
     return {};
   }
 
@@ -68,18 +77,24 @@ class SetOption : public Command {
 
   std::expected<void, std::string> Run(
       std::vector<std::string_view> args) override {
-    if (args.size() != 4) {
+    if (args.size() < 2 || args[0] != "name") {
       return std::unexpected(
           std::format("Invalid setoption command: {}", args));
     }
 
-    if (args[0] != "name" || args[2] != "value") {
+    // Both the name and the value may contain spaces (e.g., `Clear Hash`). The
+    // value is omitted for buttons.
+    auto value_it = std::ranges::find(args, "value");
+    if (value_it == args.begin() + 1 ||
+        (value_it != args.end() && value_it + 1 == args.end())) {
       return std::unexpected(
           std::format("Invalid setoption command: {}", args));
     }
 
-    std::string_view name = args[1];
-    std::string_view value = args[3];
+    const std::string name = absl::StrJoin(args.begin() + 1, value_it, " ");
+    const std::string value =
+        value_it == args.end() ? ""
+                               : absl::StrJoin(value_it + 1, args.end(), " ");
 
     for (Option* option : GetOptions()) {
       if (option->GetName() == name) {
@@ -100,23 +115,150 @@ class Go : public Command {
 
   std::expected<void, std::string> Run(
       std::vector<std::string_view> args) override {
+    std::expected<SearchOptions, std::string> options = ParseOptions(args);
+    if (!options.has_value()) {
+      return std::unexpected(options.error());
+    }
+
+    // The search runs in the background, so that `stop`, `ponderhit`, and
+    // `isready` are answered while searching.
+    const Printer& printer = state_.printer;
+    state_.searcher.StartSearch(
+        state_.game,
+        options->SetThreads(state_.threads)
+            .SetEvalCacheSize(state_.eval_cache_size_mb)
+            .SetNetwork(state_.network)
+            .SetInfoObserver([&printer](const SearchInfo& info) {
+              printer.Println(std::cout, "{}", info);
+            }),
+        [&printer](const SearchResult& result) {
+          if (result.ponder_move == Move::NullMove()) {
+            printer.Println(std::cout, "bestmove {}", result.best_move);
+          } else {
+            printer.Println(std::cout, "bestmove {} ponder {}",
+                            result.best_move, result.ponder_move);
+          }
+        });
+    return {};
+  }
+
+ private:
+  // Parses the search limits of a `go` command, e.g.,
+  // `go wtime 60000 btime 60000 winc 1000 binc 1000`.
+  std::expected<SearchOptions, std::string> ParseOptions(
+      std::vector<std::string_view> args) const {
+    using std::chrono::milliseconds;
     constexpr int kDefaultSearchDepth = 6;
-    int depth = kDefaultSearchDepth;
 
-    for (int i = 0; i < args.size() - 1; i += 2) {
-      if (args[i] == "depth") {
-        depth = std::stoi(std::string(args[i + 1]));
+    std::optional<int> depth;
+    bool infinite = false;
+    bool ponder = false;
+    std::array<std::optional<milliseconds>, kNumSides> time_left;
+    std::array<milliseconds, kNumSides> increment = {};
+    SearchOptions options;
+
+    for (int i = 0; i < args.size(); ++i) {
+      const std::string_view name = args[i];
+      if (name == "infinite") {
+        infinite = true;
+        continue;
+      }
+      if (name == "ponder") {
+        ponder = true;
+        continue;
+      }
+
+      if (i + 1 == args.size()) {
+        return std::unexpected(std::format("Missing {} value", name));
       }
+      const std::string_view value = args[++i];
+      std::expected<std::int64_t, std::string> number =
+          ParseNumber(name, value);
+      if (!number.has_value()) {
+        return std::unexpected(number.error());
+      }
+
+      if (name == "depth") {
+        if (*number < 1 || *number > kMaxSearchDepth) {
+          return std::unexpected(std::format("Invalid depth value: {}", value));
+        }
+        depth = static_cast<int>(*number);
+      } else if (name == "nodes") {
+        options.SetNodes(*number);
+      } else if (name == "wtime") {
+        time_left[kWhite] = milliseconds(*number);
+      } else if (name == "btime") {
+        time_left[kBlack] = milliseconds(*number);
+      } else if (name == "winc") {
+        increment[kWhite] = milliseconds(*number);
+      } else if (name == "binc") {
+        increment[kBlack] = milliseconds(*number);
+      } else if (name == "movestogo") {
+        options.time_control.moves_to_go = static_cast<int>(*number);
+      } else if (name == "movetime") {
+        options.time_control.move_time = milliseconds(*number);
+      } else {
+        return std::unexpected(std::format("Invalid go parameter: {}", name));
+      }
+    }
+
+    if (infinite) {
+      // Search until `stop`, regardless of the clock.
+      options.time_control = TimeControl();
+      options.nodes = std::nullopt;
+    } else {
+      const Side side = state_.game.GetPosition().SideToMove();
+      options.time_control.time_left = time_left[side];
+      options.time_control.increment = increment[side];
+    }
+
+    // Without a depth, the search runs until another limit is hit.
+    const bool limited = options.time_control.time_left ||
+                         options.time_control.move_time || options.nodes;
+    if (!depth) {
+      depth = infinite || limited ? kMaxSearchDepth : kDefaultSearchDepth;
+    }
+    options.SetDepth(*depth).SetInfinite(infinite).SetPonder(ponder);
+    return options;
+  }
+
+  static std::expected<std::int64_t, std::string> ParseNumber(
+      std::string_view name, std::string_view value) {
+    std::int64_t result = 0;
+    const char* end = value.data() + value.size();
+    auto [ptr, error] = std::from_chars(value.data(), end, result);
+    if (error != std::errc() || ptr != end) {
+      return std::unexpected(std::format("Invalid {} value: {}", name, value));
     }
+    return result;
+  }
+
+  CommandState& state_;
+};
 
-    Move move = Search(state_.game,
-                       SearchOptions()       //
-                           .SetDepth(depth)  //
-                           .SetInfoObserver([&](const SearchInfo& info) {
-                             state_.printer.Println(std::cout, "{}", info);
-                           }));
+class Stop : public Command {
+ public:
+  explicit Stop(CommandState& state) : state_(state) {}
 
-    state_.printer.Println(std::cout, "bestmove {}", move);
+  std::expected<void, std::string> Run(
+      std::vector<std::string_view> args) override {
+    // The best move is printed by the search before this returns.
+    state_.searcher.Stop();
+    state_.searcher.Wait();
+    return {};
+  }
+
+ private:
+  CommandState& state_;
+};
+
+class PonderHit : public Command {
+ public:
+  explicit PonderHit(CommandState& state) : state_(state) {}
+
+  std::expected<void, std::string> Run(
+      std::vector<std::string_view> args) override {
+    state_.searcher.PonderHit();
     return {};
   }
 
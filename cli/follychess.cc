@@ -21,6 +21,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "cli.h"
+#include "engine/cpu.h"
 
 int main(int argc, char **argv) {
   std::println(R"(
@@ -37,6 +38,16 @@ int main(int argc, char **argv) {
    FollyChess
 )");
 
+  // The compiler may use the build's instruction sets anywhere, so a CPU
+  // without them would fail with an illegal instruction at some later point.
+  if (!follychess::GetCpuFeatures().Includes(follychess::kBuildCpuFeatures)) {
+    std::println(std::cerr,
+                 "This build needs a CPU with {}, but this CPU only has {}.",
+                 follychess::ToString(follychess::kBuildCpuFeatures),
+                 follychess::ToString(follychess::GetCpuFeatures()));
+    return EXIT_FAILURE;
+  }
+
   using ::follychess::Command;
   using ::follychess::CommandDispatcher;
   using ::follychess::CommandState;
@@ -59,6 +70,9 @@ int main(int argc, char **argv) {
     state.printer.PrintStdIn(command);
 
     if (command == "quit") {
+      // Lets a running search print its best move before exiting.
+      state.searcher.Stop();
+      state.searcher.Wait();
       return EXIT_SUCCESS;
     }
 
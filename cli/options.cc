@@ -17,13 +17,29 @@
 
 #include "options.h"
 
+#include <charconv>
 #include <chrono>
+#include <memory>
 
 namespace follychess {
 namespace {
 
 namespace fs = std::filesystem;
 
+// Parses the value of a `spin` option, which must be an integer in the
+// inclusive range [min, max].
+std::expected<int, std::string> ParseSpin(std::string_view name,
+                                          std::string_view value, int min,
+                                          int max) {
+  int result = 0;
+  const char* end = value.data() + value.size();
+  auto [ptr, error] = std::from_chars(value.data(), end, result);
+  if (error != std::errc() || ptr != end || result < min || result > max) {
+    return std::unexpected(std::format("Invalid {} value: {}", name, value));
+  }
+  return result;
+}
+
 class LogDirectory : public Option {
  public:
   [[nodiscard]] std::string_view GetName() const override {
@@ -44,13 +60,134 @@ class LogDirectory : public Option {
   }
 };
 
+class Threads : public Option {
+ public:
+  [[nodiscard]] std::string_view GetName() const override { return "Threads"; }
+
+  [[nodiscard]] std::string_view GetType() const override {
+    return "type spin default 1 min 1 max 512";
+  }
+
+  std::expected<void, std::string> Set(std::string_view value,
+                                       CommandState& state) override {
+    std::expected<int, std::string> threads =
+        ParseSpin(GetName(), value, /*min=*/1, /*max=*/512);
+    if (!threads.has_value()) {
+      return std::unexpected(threads.error());
+    }
+
+    state.threads = *threads;
+    return {};
+  }
+};
+
+class Hash : public Option {
+ public:
+  [[nodiscard]] std::string_view GetName() const override { return "Hash"; }
+
+  [[nodiscard]] std::string_view GetType() const override {
+    return "type spin default 256 min 1 max 65536";
+  }
+
+  std::expected<void, std::string> Set(std::string_view value,
+                                       CommandState& state) override {
+    std::expected<int, std::string> size_mb =
+        ParseSpin(GetName(), value, /*min=*/1, /*max=*/65536);
+    if (!size_mb.has_value()) {
+      return std::unexpected(size_mb.error());
+    }
+
+    state.searcher.ResizeHash(*size_mb, state.threads);
+    return {};
+  }
+};
+
+class EvalCacheSize : public Option {
+ public:
+  [[nodiscard]] std::string_view GetName() const override {
+    return "EvalCache";
+  }
+
+  [[nodiscard]] std::string_view GetType() const override {
+    return "type spin default 1 min 0 max 1024";
+  }
+
+  std::expected<void, std::string> Set(std::string_view value,
+                                       CommandState& state) override {
+    std::expected<int, std::string> size_mb =
+        ParseSpin(GetName(), value, /*min=*/0, /*max=*/1024);
+    if (!size_mb.has_value()) {
+      return std::unexpected(size_mb.error());
+    }
+
+    state.eval_cache_size_mb = *size_mb;
+    return {};
+  }
+};
+
+class EvalFile : public Option {
+ public:
+  [[nodiscard]] std::string_view GetName() const override {
+    return "EvalFile";
+  }
+
+  [[nodiscard]] std::string_view GetType() const override {
+    return "type string default <empty>";
+  }
+
+  // An empty value switches back to the handcrafted evaluation.
+  std::expected<void, std::string> Set(std::string_view value,
+                                       CommandState& state) override {
+    if (value.empty() || value == "<empty>") {
+      state.network = nullptr;
+      return {};
+    }
+
+    std::expected<nnue::Network, std::string> network =
+        nnue::Network::Load(fs::path(value));
+    if (!network.has_value()) {
+      return std::unexpected(network.error());
+    }
+
+    state.network = std::make_shared<const nnue::Network>(*std::move(network));
+    return {};
+  }
+};
+
+class ClearHash : public Option {
+ public:
+  [[nodiscard]] std::string_view GetName() const override {
+    return "Clear Hash";
+  }
+
+  [[nodiscard]] std::string_view GetType() const override {
+    return "type button";
+  }
+
+  std::expected<void, std::string> Set(std::string_view value,
+                                       CommandState& state) override {
+    state.searcher.ClearHash(state.threads);
+    return {};
+  }
+};
+
 }  // namespace
 
 std::vector<Option*> GetOptions() {
   static LogDirectory kLogDirectory;
+  static Threads kThreads;
+  static Hash kHash;
+  static ClearHash kClearHash;
+  static EvalCacheSize kEvalCacheSize;
+  static EvalFile kEvalFile;
 
   return {
       &kLogDirectory,
+      &kThreads,
+      &kHash,
+      &kClearHash,
+      &kEvalCacheSize,
+      &kEvalFile,
   };
 }
 
@@ -119,6 +119,37 @@ class MagicSliderAttacks {
   }
 };
 
+// Looks up attacks with the BMI2 PEXT instruction, which maps the relevant
+// occupancy of a square directly to a dense index. This avoids the multiply
+// and shift of magic bitboards. The per-square offsets and masks are shared
+// with the magic tables, so both tables have the same size.
+//
+// This must only run on CPUs with BMI2. The engine uses it in the code
+// compiled for Isa::kBmi2, where the instruction is inlined. PEXT is slow on
+// AMD processors before Zen 3, which use magic bitboards instead.
+class PextSliderAttacks {
+ public:
+  static constexpr Bitboard GetBishopAttacks(Square square, Bitboard occupied) {
+    const MagicEntry &magic = kSliderAttacks.bishop_magic_squares[square];
+    return kPextSliderAttacks[magic.attack_table_index +
+                              GetIndex(occupied, magic.mask)];
+  }
+
+  static constexpr Bitboard GetRookAttacks(Square square, Bitboard occupied) {
+    const MagicEntry &magic = kSliderAttacks.rook_magic_squares[square];
+    return kPextSliderAttacks[magic.attack_table_index +
+                              GetIndex(occupied, magic.mask)];
+  }
+
+ private:
+  static constexpr std::size_t GetIndex(Bitboard occupied, Bitboard mask) {
+    if consteval {
+      return ExtractBits(occupied.Data(), mask.Data());
+    }
+    return ExtractBitsBmi2(occupied.Data(), mask.Data());
+  }
+};
+
 class LazySliderAttacks {
  public:
   static constexpr Bitboard GetBishopAttacks(Square square, Bitboard occupied) {
@@ -185,7 +216,11 @@ class MapSliderAttacks {
   }
 };
 
-template <Piece Piece, typename SliderAttacks = MagicSliderAttacks>
+// The slider attacks of code that is not compiled per instruction set. The
+// hot code gets its policy from DispatchIsa() in engine/isa_dispatch.h.
+using DefaultSliderAttacks = MagicSliderAttacks;
+
+template <Piece Piece, typename SliderAttacks = DefaultSliderAttacks>
   requires SliderAttacksPolicy<SliderAttacks>
 constexpr Bitboard GenerateAttacks(Square square, Bitboard occupied) {
   static_assert(Piece != kPawn);
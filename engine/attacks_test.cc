@@ -20,6 +20,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <map>
+#include <type_traits>
+
+#include "engine/cpu.h"
 #include "engine/testing.h"
 
 namespace follychess {
@@ -987,11 +991,26 @@ TEST(MakePowerSet, RookMask) {
                          }));
 }
 
-TEST(LazySliderAttacks, Bishop) {
+template <typename T>
+class SliderAttacksTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    if (std::is_same_v<T, PextSliderAttacks> && !IsSupported(Isa::kBmi2)) {
+      GTEST_SKIP() << "PextSliderAttacks needs BMI2.";
+    }
+  }
+};
+
+using SliderAttacksPolicies =
+    testing::Types<MagicSliderAttacks, PextSliderAttacks, LazySliderAttacks,
+                   MapSliderAttacks<std::map>>;
+TYPED_TEST_SUITE(SliderAttacksTest, SliderAttacksPolicies);
+
+TYPED_TEST(SliderAttacksTest, Bishop) {
   {
     Bitboard blockers = kEmptyBoard;
 
-    EXPECT_THAT((GenerateAttacks<kBishop, LazySliderAttacks>(D5, blockers)),
+    EXPECT_THAT((GenerateAttacks<kBishop, TypeParam>(D5, blockers)),
                 EqualsBitboard("8: X . . . . . X ."
                                "7: . X . . . X . ."
                                "6: . . X . X . . ."
@@ -1015,7 +1034,7 @@ TEST(LazySliderAttacks, Bishop) {
         "1: . . . . . . . X"
         "   a b c d e f g h");
 
-    EXPECT_THAT((GenerateAttacks<kBishop, LazySliderAttacks>(C1, blockers)),
+    EXPECT_THAT((GenerateAttacks<kBishop, TypeParam>(C1, blockers)),
                 EqualsBitboard("8: . . . . . . . ."
                                "7: . . . . . . . ."
                                "6: . . . . . . . ."
@@ -1028,7 +1047,7 @@ TEST(LazySliderAttacks, Bishop) {
   }
 }
 
-TEST(LazySliderAttacks, Rook) {
+TYPED_TEST(SliderAttacksTest, Rook) {
   {
     Bitboard blockers(
         "8: . . . . . . . ."
@@ -1041,7 +1060,7 @@ TEST(LazySliderAttacks, Rook) {
         "1: . . . X . . . ."
         "   a b c d e f g h");
 
-    EXPECT_THAT((GenerateAttacks<kRook, LazySliderAttacks>(A1, blockers)),
+    EXPECT_THAT((GenerateAttacks<kRook, TypeParam>(A1, blockers)),
                 EqualsBitboard("8: . . . . . . . ."
                                "7: . . . . . . . ."
                                "6: . . . . . . . ."
@@ -1065,7 +1084,7 @@ TEST(LazySliderAttacks, Rook) {
         "1: . . . . . . . ."
         "   a b c d e f g h");
 
-    EXPECT_THAT((GenerateAttacks<kRook, LazySliderAttacks>(A4, blockers)),
+    EXPECT_THAT((GenerateAttacks<kRook, TypeParam>(A4, blockers)),
                 EqualsBitboard("8: X . . . . . . ."
                                "7: X . . . . . . ."
                                "6: X . . . . . . ."
@@ -1089,7 +1108,7 @@ TEST(LazySliderAttacks, Rook) {
         "1: . . . . . . . ."
         "   a b c d e f g h");
 
-    EXPECT_THAT((GenerateAttacks<kRook, LazySliderAttacks>(D1, blockers)),
+    EXPECT_THAT((GenerateAttacks<kRook, TypeParam>(D1, blockers)),
                 EqualsBitboard("8: . . . X . . . ."
                                "7: . . . X . . . ."
                                "6: . . . X . . . ."
@@ -1102,7 +1121,7 @@ TEST(LazySliderAttacks, Rook) {
   }
 }
 
-TEST(LazySliderAttacks, Queen) {
+TYPED_TEST(SliderAttacksTest, Queen) {
   {
     Bitboard blockers(
         "8: . . . . . . . ."
@@ -1115,7 +1134,7 @@ TEST(LazySliderAttacks, Queen) {
         "1: . . . . . . . ."
         "   a b c d e f g h");
 
-    EXPECT_THAT((GenerateAttacks<kQueen, LazySliderAttacks>(D5, blockers)),
+    EXPECT_THAT((GenerateAttacks<kQueen, TypeParam>(D5, blockers)),
                 EqualsBitboard("8: . . . X . . X ."
                                "7: . . . X . X . ."
                                "6: . . X X X . . ."
@@ -1139,7 +1158,7 @@ TEST(LazySliderAttacks, Queen) {
         "1: X X X X X X X X"
         "   a b c d e f g h");
 
-    EXPECT_THAT((GenerateAttacks<kQueen, LazySliderAttacks>(E4, blockers)),
+    EXPECT_THAT((GenerateAttacks<kQueen, TypeParam>(E4, blockers)),
                 EqualsBitboard("8: . . . . . . . ."
                                "7: . . . . . . . ."
                                "6: . . . . . . . ."
@@ -1152,175 +1171,26 @@ TEST(LazySliderAttacks, Queen) {
   }
 }
 
-TEST(MapSliderAttacks, Bishop) {
-  {
-    Bitboard blockers = kEmptyBoard;
-
-    EXPECT_THAT(
-        (GenerateAttacks<kBishop, MapSliderAttacks<std::map>>(D5, blockers)),
-        EqualsBitboard("8: X . . . . . X ."
-                       "7: . X . . . X . ."
-                       "6: . . X . X . . ."
-                       "5: . . . . . . . ."
-                       "4: . . X . X . . ."
-                       "3: . X . . . X . ."
-                       "2: X . . . . . X ."
-                       "1: . . . . . . . X"
-                       "   a b c d e f g h"));
-  }
-
-  {
-    Bitboard blockers(
-        "8: . . . . . . . X"
-        "7: . . . . . . . ."
-        "6: . . . . . . . ."
-        "5: . . . . . . . ."
-        "4: . . . . . X . ."
-        "3: X . . . X . . ."
-        "2: . . . . . . . ."
-        "1: . . . . . . . X"
-        "   a b c d e f g h");
-
-    EXPECT_THAT(
-        (GenerateAttacks<kBishop, MapSliderAttacks<std::map>>(C1, blockers)),
-        EqualsBitboard("8: . . . . . . . ."
-                       "7: . . . . . . . ."
-                       "6: . . . . . . . ."
-                       "5: . . . . . . . ."
-                       "4: . . . . . . . ."
-                       "3: X . . . X . . ."
-                       "2: . X . X . . . ."
-                       "1: . . . . . . . ."
-                       "   a b c d e f g h"));
-  }
+TEST(SlidingAttackTables, PackedSize) {
+  EXPECT_THAT(SlidingAttackTables::kBishopAttackTableSize, Eq(5'248));
+  EXPECT_THAT(SlidingAttackTables::kRookAttackTableSize, Eq(102'400));
 }
 
-TEST(MapSliderAttacks, Rook) {
-  {
-    Bitboard blockers(
-        "8: . . . . . . . ."
-        "7: . . . . . . . ."
-        "6: . . . . . . . ."
-        "5: . . . . . . . ."
-        "4: X . . . . . . ."
-        "3: . . . . . . . ."
-        "2: . . . . . . . ."
-        "1: . . . X . . . ."
-        "   a b c d e f g h");
-
-    EXPECT_THAT(
-        (GenerateAttacks<kRook, MapSliderAttacks<std::map>>(A1, blockers)),
-        EqualsBitboard("8: . . . . . . . ."
-                       "7: . . . . . . . ."
-                       "6: . . . . . . . ."
-                       "5: . . . . . . . ."
-                       "4: X . . . . . . ."
-                       "3: X . . . . . . ."
-                       "2: X . . . . . . ."
-                       "1: . X X X . . . ."
-                       "   a b c d e f g h"));
-  }
-
-  {
-    Bitboard blockers(
-        "8: . . . . . . . ."
-        "7: . . . . . . . ."
-        "6: . . . . . . . ."
-        "5: . . . . . . . ."
-        "4: . . X . X . . ."
-        "3: . . . . . . . ."
-        "2: . . . . . . . ."
-        "1: . . . . . . . ."
-        "   a b c d e f g h");
-
-    EXPECT_THAT(
-        (GenerateAttacks<kRook, MapSliderAttacks<std::map>>(A4, blockers)),
-        EqualsBitboard("8: X . . . . . . ."
-                       "7: X . . . . . . ."
-                       "6: X . . . . . . ."
-                       "5: X . . . . . . ."
-                       "4: . X X . . . . ."
-                       "3: X . . . . . . ."
-                       "2: X . . . . . . ."
-                       "1: X . . . . . . ."
-                       "   a b c d e f g h"));
-  }
-
-  {
-    Bitboard blockers(
-        "8: . . . X . . . ."
-        "7: . . . . . . . ."
-        "6: . . . . . . . ."
-        "5: . . X . X . . ."
-        "4: . . . . . . . ."
-        "3: . . . . . . . ."
-        "2: . . . . . . . ."
-        "1: . . . . . . . ."
-        "   a b c d e f g h");
-
-    EXPECT_THAT(
-        (GenerateAttacks<kRook, MapSliderAttacks<std::map>>(D1, blockers)),
-        EqualsBitboard("8: . . . X . . . ."
-                       "7: . . . X . . . ."
-                       "6: . . . X . . . ."
-                       "5: . . . X . . . ."
-                       "4: . . . X . . . ."
-                       "3: . . . X . . . ."
-                       "2: . . . X . . . ."
-                       "1: X X X . X X X X"
-                       "   a b c d e f g h"));
-  }
-}
-
-TEST(MapSliderAttacks, Queen) {
-  {
-    Bitboard blockers(
-        "8: . . . . . . . ."
-        "7: . . . . . . . ."
-        "6: . . X . . . . ."
-        "5: . . . . . . . ."
-        "4: . . . X . . . ."
-        "3: . . . . . X . ."
-        "2: . . . . . . . ."
-        "1: . . . . . . . ."
-        "   a b c d e f g h");
-
-    EXPECT_THAT(
-        (GenerateAttacks<kQueen, MapSliderAttacks<std::map>>(D5, blockers)),
-        EqualsBitboard("8: . . . X . . X ."
-                       "7: . . . X . X . ."
-                       "6: . . X X X . . ."
-                       "5: X X X . X X X X"
-                       "4: . . X X X . . ."
-                       "3: . X . . . X . ."
-                       "2: X . . . . . . ."
-                       "1: . . . . . . . ."
-                       "   a b c d e f g h"));
-  }
-
-  {
-    Bitboard blockers(
-        "8: X X X X X X X X"
-        "7: X X X X X X X X"
-        "6: X X X X X X X X"
-        "5: X X X X X X X X"
-        "4: X X X X X X X X"
-        "3: X X X X X X X X"
-        "2: X X X X X X X X"
-        "1: X X X X X X X X"
-        "   a b c d e f g h");
-
-    EXPECT_THAT(
-        (GenerateAttacks<kQueen, MapSliderAttacks<std::map>>(E4, blockers)),
-        EqualsBitboard("8: . . . . . . . ."
-                       "7: . . . . . . . ."
-                       "6: . . . . . . . ."
-                       "5: . . . X X X . ."
-                       "4: . . . X . X . ."
-                       "3: . . . X X X . ."
-                       "2: . . . . . . . ."
-                       "1: . . . . . . . ."
-                       "   a b c d e f g h"));
+TYPED_TEST(SliderAttacksTest, MatchesLazySliderAttacksForAllOccupancies) {
+  for (int square = kFirstSquare; square < kNumSquares; ++square) {
+    const auto from = static_cast<Square>(square);
+    for (const Bitboard occupied :
+         MakePowerSet(kSliderAttacks.bishop_magic_squares[square].mask)) {
+      ASSERT_THAT(TypeParam::GetBishopAttacks(from, occupied),
+                  Eq(LazySliderAttacks::GetBishopAttacks(from, occupied)))
+          << ToString(from);
+    }
+    for (const Bitboard occupied :
+         MakePowerSet(kSliderAttacks.rook_magic_squares[square].mask)) {
+      ASSERT_THAT(TypeParam::GetRookAttacks(from, occupied),
+                  Eq(LazySliderAttacks::GetRookAttacks(from, occupied)))
+          << ToString(from);
+    }
   }
 }
 
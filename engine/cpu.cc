@@ -0,0 +1,122 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "cpu.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/str_join.h"
+
+namespace follychess {
+namespace {
+
+CpuFeatures DetectCpuFeatures() {
+  CpuFeatures features;
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  features.popcnt = __builtin_cpu_supports("popcnt");
+  features.bmi2 = __builtin_cpu_supports("bmi2");
+  features.sse4_1 = __builtin_cpu_supports("sse4.1");
+  features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+  return features;
+}
+
+// PEXT is microcoded on AMD processors before Zen 3, where it is much slower
+// than a magic bitboard lookup.
+bool HasFastPext() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  return !__builtin_cpu_is("amdfam15h") && !__builtin_cpu_is("amdfam17h");
+#else
+  return false;
+#endif
+}
+
+}  // namespace
+
+const CpuFeatures &GetCpuFeatures() {
+  static const CpuFeatures kFeatures = DetectCpuFeatures();
+  return kFeatures;
+}
+
+std::string ToString(const CpuFeatures &features) {
+  std::vector<std::string_view> names;
+  if (features.popcnt) {
+    names.push_back("popcnt");
+  }
+  if (features.bmi2) {
+    names.push_back("bmi2");
+  }
+  if (features.sse4_1) {
+    names.push_back("sse4.1");
+  }
+  if (features.avx2) {
+    names.push_back("avx2");
+  }
+  if (names.empty()) {
+    return "none";
+  }
+  return absl::StrJoin(names, " ");
+}
+
+bool IsSupported(const Isa isa) {
+  const CpuFeatures &features = GetCpuFeatures();
+  switch (isa) {
+    case Isa::kGeneric:
+      return true;
+    case Isa::kPopcnt:
+      return features.popcnt;
+    case Isa::kBmi2:
+      // Every CPU with BMI2 also has BMI1.
+      return features.popcnt && features.bmi2;
+  }
+  return false;
+}
+
+Isa GetBestIsa() {
+  static const Isa kBestIsa = [] {
+    if (IsSupported(Isa::kBmi2) && HasFastPext()) {
+      return Isa::kBmi2;
+    }
+    if (IsSupported(Isa::kPopcnt)) {
+      return Isa::kPopcnt;
+    }
+    return Isa::kGeneric;
+  }();
+  return kBestIsa;
+}
+
+std::string_view ToString(const Isa isa) {
+  switch (isa) {
+    case Isa::kGeneric:
+      return "generic";
+    case Isa::kPopcnt:
+      return "popcnt";
+    case Isa::kBmi2:
+      return "bmi2";
+  }
+  return "";
+}
+
+std::string_view GetSliderAttacksName(const Isa isa) {
+  return isa == Isa::kBmi2 ? "pext" : "magic";
+}
+
+}  // namespace follychess
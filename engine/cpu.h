@@ -0,0 +1,100 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_ENGINE_CPU_H_
+#define FOLLYCHESS_ENGINE_CPU_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace follychess {
+
+// Instruction set extensions that the engine has faster code paths for.
+struct CpuFeatures {
+  bool popcnt = false;
+  bool bmi2 = false;
+  bool sse4_1 = false;
+  bool avx2 = false;
+
+  // Returns true if every feature in `other` is also in this.
+  [[nodiscard]] constexpr bool Includes(const CpuFeatures &other) const {
+    return (popcnt || !other.popcnt) && (bmi2 || !other.bmi2) &&
+           (sse4_1 || !other.sse4_1) && (avx2 || !other.avx2);
+  }
+
+  bool operator==(const CpuFeatures &other) const = default;
+};
+
+// The features that the compiler may use anywhere in the binary. The build
+// enables none by default, since the hot code is compiled for each `Isa`
+// regardless. A build that passes flags such as `-mbmi2` only runs on CPUs
+// that have them.
+inline constexpr CpuFeatures kBuildCpuFeatures = {
+#ifdef __POPCNT__
+    .popcnt = true,
+#endif
+#ifdef __BMI2__
+    .bmi2 = true,
+#endif
+#ifdef __SSE4_1__
+    .sse4_1 = true,
+#endif
+#ifdef __AVX2__
+    .avx2 = true,
+#endif
+};
+
+// Returns the features of the CPU that the engine is running on, as reported
+// by CPUID. Kernels that are compiled for several instruction sets, such as
+// the NNUE evaluation, use this to choose one at startup.
+const CpuFeatures &GetCpuFeatures();
+
+// Returns the names of the features, separated by spaces, or "none".
+std::string ToString(const CpuFeatures &features);
+
+// Selects the instruction sets that the bitboard code is compiled for: the
+// popcounts and bit scans of `Bitboard`, slider attacks, move generation and
+// evaluation. All variants are compiled into every x86 binary with target
+// attributes (see engine/isa_dispatch.h), and one is chosen from CPUID at
+// startup.
+enum class Isa : std::uint8_t {
+  // No extensions, with magic slider attacks.
+  kGeneric,
+
+  // Hardware popcount, with magic slider attacks.
+  kPopcnt,
+
+  // Hardware popcount and BMI bit manipulation, with PEXT slider attacks.
+  kBmi2,
+};
+
+// Returns true if the CPU can run the variant.
+[[nodiscard]] bool IsSupported(Isa isa);
+
+// Returns the fastest variant that the CPU supports, as detected by CPUID on
+// the first call.
+[[nodiscard]] Isa GetBestIsa();
+
+[[nodiscard]] std::string_view ToString(Isa isa);
+
+// Returns the name of the slider attacks policy of the variant.
+[[nodiscard]] std::string_view GetSliderAttacksName(Isa isa);
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_CPU_H_
@@ -0,0 +1,79 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "engine/cpu.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
+TEST(CpuFeatures, Includes) {
+  const CpuFeatures none;
+  const CpuFeatures bmi2 = {.bmi2 = true};
+  const CpuFeatures bmi2_and_avx2 = {.bmi2 = true, .avx2 = true};
+
+  EXPECT_THAT(none.Includes(none), IsTrue());
+  EXPECT_THAT(bmi2.Includes(none), IsTrue());
+  EXPECT_THAT(none.Includes(bmi2), IsFalse());
+  EXPECT_THAT(bmi2_and_avx2.Includes(bmi2), IsTrue());
+  EXPECT_THAT(bmi2.Includes(bmi2_and_avx2), IsFalse());
+}
+
+TEST(CpuFeatures, CpuIncludesBuildFeatures) {
+  EXPECT_THAT(GetCpuFeatures().Includes(kBuildCpuFeatures), IsTrue());
+}
+
+TEST(CpuFeatures, ToString) {
+  EXPECT_THAT(ToString(CpuFeatures()), Eq("none"));
+  EXPECT_THAT(ToString({.popcnt = true, .sse4_1 = true}), Eq("popcnt sse4.1"));
+  EXPECT_THAT(ToString({
+                  .popcnt = true,
+                  .bmi2 = true,
+                  .sse4_1 = true,
+                  .avx2 = true,
+              }),
+              Eq("popcnt bmi2 sse4.1 avx2"));
+}
+
+TEST(Isa, GenericIsAlwaysSupported) {
+  EXPECT_THAT(IsSupported(Isa::kGeneric), IsTrue());
+}
+
+TEST(Isa, BestIsSupported) {
+  EXPECT_THAT(IsSupported(GetBestIsa()), IsTrue());
+}
+
+TEST(Isa, FollowsCpuFeatures) {
+  EXPECT_THAT(IsSupported(Isa::kPopcnt), Eq(GetCpuFeatures().popcnt));
+  EXPECT_THAT(IsSupported(Isa::kBmi2),
+              Eq(GetCpuFeatures().popcnt && GetCpuFeatures().bmi2));
+}
+
+TEST(Isa, ToString) {
+  EXPECT_THAT(ToString(Isa::kGeneric), Eq("generic"));
+  EXPECT_THAT(ToString(Isa::kPopcnt), Eq("popcnt"));
+  EXPECT_THAT(ToString(Isa::kBmi2), Eq("bmi2"));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -23,11 +23,11 @@ int Game::GetRepetitionCount() const {
   int repetitions = 1;
   const ZobristKey current_key = GetPosition().GetKey();
 
-  const int start = std::ssize(history_) - 3;
-  const int limit = std::ssize(history_) - 1 - GetPosition().GetHalfMoves();
+  const int start = std::ssize(keys_) - 3;
+  const int limit = std::ssize(keys_) - 1 - GetPosition().GetHalfMoves();
 
   for (int i = start; i >= std::max(limit, 0); --i) {
-    if (history_[i].key == current_key) {
+    if (keys_[i] == current_key) {
       ++repetitions;
     }
   }
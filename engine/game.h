@@ -19,53 +19,84 @@
 #define FOLLYCHESS_ENGINE_GAME_H_
 
 #include <utility>
+#include <vector>
 
+#include "engine/move.h"
 #include "engine/position.h"
+#include "engine/zobrist.h"
 
 namespace follychess {
 
 class Game {
  public:
-  explicit Game(Position position) {
-    history_.push_back({
-        .key = position.GetKey(),
-        .position = std::move(position),
-    });
+  // How Undo() restores the previous position.
+  enum class Mode {
+    // Keeps a copy of every earlier position and restores it on Undo().
+    kCopyMake,
+
+    // Keeps a single position and the UndoInfo of each move, and reverts the
+    // move on Undo(). Do() and Undo() never copy a Position.
+    kMakeUnmake,
+  };
+
+  explicit Game(Position position, Mode mode = Mode::kMakeUnmake)
+      : position_(std::move(position)), mode_(mode) {
+    keys_.reserve(kReservedPlies);
+    if (mode_ == Mode::kCopyMake) {
+      positions_.reserve(kReservedPlies);
+    } else {
+      undo_infos_.reserve(kReservedPlies);
+    }
+    keys_.push_back(position_.GetKey());
   }
 
   Game() : Game(Position::Starting()) {}
 
   void Do(Move move) {
-    DCHECK(!history_.empty());
-
-    // Extends the history:
-    history_.push_back(history_.back());
-
-    // Mutates the last position in place:
-    Position& position = history_.back().position;
-    position.Do(move);
-    history_.back().key = position.GetKey();
+    if (mode_ == Mode::kCopyMake) {
+      positions_.push_back(position_);
+      position_.Do(move);
+    } else {
+      undo_infos_.push_back(position_.Do(move));
+    }
+    keys_.push_back(position_.GetKey());
   }
 
   void Undo() {
-    DCHECK(!history_.empty());
-    history_.pop_back();
+    DCHECK_GT(keys_.size(), 1);
+    if (mode_ == Mode::kCopyMake) {
+      position_ = positions_.back();
+      positions_.pop_back();
+    } else {
+      position_.Undo(undo_infos_.back());
+      undo_infos_.pop_back();
+    }
+    keys_.pop_back();
   }
 
   [[nodiscard]] int GetRepetitionCount() const;
 
-  [[nodiscard]] const Position& GetPosition() const {
-    DCHECK(!history_.empty());
-    return history_.back().position;
-  }
+  [[nodiscard]] const Position& GetPosition() const { return position_; }
+
+  [[nodiscard]] Mode GetMode() const { return mode_; }
 
  private:
-  struct State {
-    ZobristKey key;
-    Position position;
-  };
+  // Enough for the moves of a long game plus a deep search, so that the
+  // stacks below do not grow while searching.
+  static constexpr int kReservedPlies = 1024;
+
+  Position position_;
+  Mode mode_;
+
+  // The key of every position of the game, from the first to the current
+  // one.
+  std::vector<ZobristKey> keys_;
+
+  // Only used in `kCopyMake` mode: every position before the current one.
+  std::vector<Position> positions_;
 
-  std::vector<State> history_;
+  // Only used in `kMakeUnmake` mode: the UndoInfo of every move.
+  std::vector<UndoInfo> undo_infos_;
 };
 
 }  // namespace follychess
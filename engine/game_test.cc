@@ -169,5 +169,50 @@ TEST(GetRepetitionCount, FourFoldRepetition) {
   EXPECT_THAT(game.GetRepetitionCount(), Eq(5));
 }
 
+class GameModeTest : public ::testing::TestWithParam<Game::Mode> {};
+
+TEST_P(GameModeTest, DoAndUndo) {
+  const Position start =
+      Position::FromFen(
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")
+          .value();
+  Game game(start, GetParam());
+
+  game.Do(MakeMove("e1g1#oo"));
+  const Position after_castling = game.GetPosition();
+  game.Do(MakeMove("a6e2#c"));
+  game.Do(MakeMove("e5f7#c"));
+  EXPECT_THAT(game.GetPosition(), Ne(after_castling));
+
+  game.Undo();
+  game.Undo();
+  EXPECT_THAT(game.GetPosition(), Eq(after_castling));
+  EXPECT_THAT(game.GetPosition().GetKey(), Eq(after_castling.GetKey()));
+
+  game.Undo();
+  EXPECT_THAT(game.GetPosition(), Eq(start));
+}
+
+TEST_P(GameModeTest, RepetitionCountAfterUndo) {
+  Game game(Position::Starting(), GetParam());
+  for (int i = 0; i < 2; ++i) {
+    game.Do(MakeMove("g1f3"));
+    game.Do(MakeMove("g8f6"));
+    game.Do(MakeMove("f3g1"));
+    game.Do(MakeMove("f6g8"));
+  }
+  EXPECT_THAT(game.GetRepetitionCount(), Eq(3));
+
+  game.Undo();
+  EXPECT_THAT(game.GetRepetitionCount(), Eq(2));
+
+  game.Do(MakeMove("f6g8"));
+  EXPECT_THAT(game.GetRepetitionCount(), Eq(3));
+}
+
+INSTANTIATE_TEST_SUITE_P(Game, GameModeTest,
+                         ::testing::Values(Game::Mode::kCopyMake,
+                                           Game::Mode::kMakeUnmake));
+
 }  // namespace
 }  // namespace follychess
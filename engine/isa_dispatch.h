@@ -0,0 +1,92 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_ENGINE_ISA_DISPATCH_H_
+#define FOLLYCHESS_ENGINE_ISA_DISPATCH_H_
+
+#include "absl/log/check.h"
+#include "engine/attacks.h"
+#include "engine/cpu.h"
+
+namespace follychess {
+namespace internal {
+
+// Each variant calls `function` with its slider attacks policy. `flatten`
+// inlines the whole call tree of `function`, so that it is compiled for the
+// variant's instruction sets, including the inline Bitboard operations.
+// Functions defined in other translation units cannot be inlined, and run
+// their own dispatch.
+template <typename Function>
+[[gnu::flatten]] decltype(auto) RunGeneric(Function &function) {
+  return function.template operator()<MagicSliderAttacks>();
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+template <typename Function>
+[[gnu::target("popcnt"), gnu::flatten]] decltype(auto) RunPopcnt(
+    Function &function) {
+  return function.template operator()<MagicSliderAttacks>();
+}
+
+template <typename Function>
+[[gnu::target("popcnt,bmi,bmi2"), gnu::flatten]] decltype(auto) RunBmi2(
+    Function &function) {
+  return function.template operator()<PextSliderAttacks>();
+}
+#else
+// Only the generic variant is supported, so the others just need to compile.
+template <typename Function>
+decltype(auto) RunPopcnt(Function &function) {
+  return RunGeneric(function);
+}
+
+template <typename Function>
+decltype(auto) RunBmi2(Function &function) {
+  return RunGeneric(function);
+}
+#endif
+
+}  // namespace internal
+
+// Calls `function.template operator()<SliderAttacks>()` in the code of the
+// given variant, which the CPU must support. `function` is usually a generic
+// lambda that calls templates of the same translation unit with the slider
+// attacks policy of the variant:
+//
+//   return DispatchIsa(isa, [&]<typename SliderAttacks>() {
+//     return CountMoves<SliderAttacks>(position);
+//   });
+//
+// The dispatch is a predictable branch per call, so it belongs at entry points
+// that do enough work to hide it, such as generating all moves of a position.
+template <typename Function>
+decltype(auto) DispatchIsa(const Isa isa, Function &&function) {
+  DCHECK(IsSupported(isa));
+  switch (isa) {
+    case Isa::kGeneric:
+      return internal::RunGeneric(function);
+    case Isa::kPopcnt:
+      return internal::RunPopcnt(function);
+    case Isa::kBmi2:
+      return internal::RunBmi2(function);
+  }
+  return internal::RunGeneric(function);
+}
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_ISA_DISPATCH_H_
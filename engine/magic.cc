@@ -17,13 +17,17 @@
 
 #include "magic.h"
 
+#include "absl/log/check.h"
 #include "absl/log/log.h"
 
 namespace follychess {
 
+// Finds a magic number for the square and writes its attacks to the attack
+// table, starting at `attack_table_index`. Returns the number of slots used.
 template <Direction... Directions>
-void FindMagicForSquare(Square from, std::size_t attack_table_index,
-                        Bitboard *attack_table, MagicEntry &magic_struct) {
+std::size_t FindMagicForSquare(Square from, std::size_t attack_table_index,
+                               Bitboard *attack_table,
+                               MagicEntry &magic_struct) {
   Bitboard mask = (MakeRay<Directions>(from) | ...);
   std::vector<Bitboard> occupancies = MakePowerSet(mask);
   std::uint8_t shift = 64 - mask.GetCount();
@@ -72,7 +76,7 @@ void FindMagicForSquare(Square from, std::size_t attack_table_index,
           .shift = shift,
           .attack_table_index = attack_table_index,
       };
-      break;
+      return placements.size();
     }
   }
 }
@@ -80,26 +84,54 @@ void FindMagicForSquare(Square from, std::size_t attack_table_index,
 SlidingAttackTables GenerateSlidingAttacks() {
   SlidingAttackTables sliding_attacks;
 
+  // Each square's attacks start right after the previous square's.
+  std::size_t attack_table_index = 0;
+
   LOG(INFO) << "Finding magic numbers for bishops:";
   for (int square = kFirstSquare; square < kNumSquares; ++square) {
     const auto from = static_cast<Square>(square);
-    FindMagicForSquare<kNorthEast, kSouthEast, kSouthWest, kNorthWest>(
-        from, (1 << 9) * from, sliding_attacks.attacks.begin(),
-        sliding_attacks.bishop_magic_squares[square]);
+    attack_table_index +=
+        FindMagicForSquare<kNorthEast, kSouthEast, kSouthWest, kNorthWest>(
+            from, attack_table_index, sliding_attacks.attacks.begin(),
+            sliding_attacks.bishop_magic_squares[square]);
   }
-
-  std::size_t rook_attack_table_index =
-      SlidingAttackTables::kBishopTableSizePerSquare * kNumSquares;
+  DCHECK_EQ(attack_table_index, SlidingAttackTables::kBishopAttackTableSize);
 
   LOG(INFO) << "Finding magic numbers for rooks:";
   for (int square = kFirstSquare; square < kNumSquares; ++square) {
     const auto from = static_cast<Square>(square);
-    FindMagicForSquare<kNorth, kEast, kSouth, kWest>(
-        from, rook_attack_table_index + (1 << 12) * from,
-        sliding_attacks.attacks.begin(),
+    attack_table_index += FindMagicForSquare<kNorth, kEast, kSouth, kWest>(
+        from, attack_table_index, sliding_attacks.attacks.begin(),
         sliding_attacks.rook_magic_squares[square]);
   }
+  DCHECK_EQ(attack_table_index, SlidingAttackTables::kAttackTableSize);
   return sliding_attacks;
 }
 
+namespace {
+
+template <Direction... Directions>
+void FillPextAttacksForSquare(Square from, const MagicEntry &magic,
+                              std::vector<Bitboard> &pext_attacks) {
+  for (Bitboard occupied : MakePowerSet(magic.mask)) {
+    std::size_t index = ExtractBits(occupied.Data(), magic.mask.Data());
+    pext_attacks[magic.attack_table_index + index] =
+        GenerateSlidingAttacks<Directions...>(from, occupied);
+  }
+}
+
+}  // namespace
+
+std::vector<Bitboard> GeneratePextAttacks(const SlidingAttackTables &tables) {
+  std::vector<Bitboard> pext_attacks(SlidingAttackTables::kAttackTableSize);
+  for (int square = kFirstSquare; square < kNumSquares; ++square) {
+    const auto from = static_cast<Square>(square);
+    FillPextAttacksForSquare<kNorthEast, kSouthEast, kSouthWest, kNorthWest>(
+        from, tables.bishop_magic_squares[square], pext_attacks);
+    FillPextAttacksForSquare<kNorth, kEast, kSouth, kWest>(
+        from, tables.rook_magic_squares[square], pext_attacks);
+  }
+  return pext_attacks;
+}
+
 }  // namespace follychess
\ No newline at end of file
@@ -19,7 +19,13 @@
 #define FOLLYCHESS_ENGINE_MAGIC_H_
 
 #include <array>
+#include <cstdint>
 #include <random>
+#include <vector>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
 
 #include "bitboard.h"
 
@@ -76,6 +82,34 @@ constexpr std::vector<Bitboard> MakePowerSet(Bitboard mask) {
   return subsets;
 }
 
+// Gathers the bits of `value` selected by `mask` into the low bits of the
+// result, preserving their order. This is a portable version of the BMI2 PEXT
+// instruction.
+constexpr std::uint64_t ExtractBits(std::uint64_t value, std::uint64_t mask) {
+  std::uint64_t result = 0;
+  for (std::uint64_t bit = 1; mask; bit <<= 1) {
+    if (value & mask & -mask) {
+      result |= bit;
+    }
+    mask &= mask - 1;
+  }
+  return result;
+}
+
+// Like ExtractBits(), but runs the PEXT instruction. This must only run on CPUs
+// with BMI2. The target attribute lets it be inlined into the code compiled
+// for BMI2 (see engine/isa_dispatch.h) without enabling BMI2 for the build.
+#ifdef __x86_64__
+[[gnu::target("bmi2")]] inline std::uint64_t ExtractBitsBmi2(
+    std::uint64_t value, std::uint64_t mask) {
+  return _pext_u64(value, mask);
+}
+#else
+inline std::uint64_t ExtractBitsBmi2(std::uint64_t value, std::uint64_t mask) {
+  return ExtractBits(value, mask);
+}
+#endif
+
 // Holds the magic bitboard data for a single square and piece type
 // (bishop or rook).
 struct MagicEntry {
@@ -89,6 +123,19 @@ struct MagicEntry {
   std::size_t attack_table_index;
 };
 
+// Returns the number of attack table slots needed by all squares of a piece,
+// i.e., the sum of 2^(relevancy bits) over all squares.
+template <Direction... Directions>
+consteval std::size_t CountAttackTableSlots() {
+  std::size_t slots = 0;
+  for (int square = kFirstSquare; square < kNumSquares; ++square) {
+    const Bitboard mask = (MakeRay<Directions>(static_cast<Square>(square)) |
+                           ...);
+    slots += std::size_t{1} << mask.GetCount();
+  }
+  return slots;
+}
+
 struct SlidingAttackTables {
   // The following diagram shows the number of relevancy bits (i.e., squares
   // on the relevant attack rays, excluding edges) for a bishop *on* each
@@ -104,25 +151,23 @@ struct SlidingAttackTables {
   //   1: 6 5 5 5 5 5 5 6
   //      a b c d e f g h
   //
-  // The worst-case is 9 bits (in the center). For simplicity, we allocate
-  // a table of size 2^9 for every square.
-  static constexpr int kBishopTableSizePerSquare = (1 << 9);
-
   // The number of relevancy bits for a rook also varies:
   //
   //   * 12 bits for corners (a1, h1, a8, h8)
   //   * 11 bits for other edge squares
   //   * 10 bits for all other squares
   //
-  // The worst-case is 12 bits. For simplicity, we allocate a table of size 2^12
-  // for every square.
-  static constexpr int kRookTableSizePerSquare = (1 << 12);
-
-  // TODO(aryann): Consider tightly packing all attacks. Only 107,648 slots are
-  // required. The current scheme sets aside 294,912 slots, which is 2.7 times
-  // more space than is necessary.
-  static constexpr int kAttackTableSize =
-      (kBishopTableSizePerSquare + kRookTableSizePerSquare) * kNumSquares;
+  // Each square's attacks take exactly 2^(relevancy bits) slots, packed one
+  // square after another: first all bishop squares, then all rook squares.
+  // This needs 5,248 bishop slots and 102,400 rook slots (841 KiB), instead
+  // of the 294,912 slots (2.25 MiB) needed when every square is given room
+  // for the worst case of its piece.
+  static constexpr std::size_t kBishopAttackTableSize =
+      CountAttackTableSlots<kNorthEast, kSouthEast, kSouthWest, kNorthWest>();
+  static constexpr std::size_t kRookAttackTableSize =
+      CountAttackTableSlots<kNorth, kEast, kSouth, kWest>();
+  static constexpr std::size_t kAttackTableSize =
+      kBishopAttackTableSize + kRookAttackTableSize;
   std::array<Bitboard, kAttackTableSize> attacks;
 
   std::array<MagicEntry, kNumSquares> bishop_magic_squares;
@@ -131,6 +176,11 @@ struct SlidingAttackTables {
 
 SlidingAttackTables GenerateSlidingAttacks();
 
+// Returns the attack table for PEXT lookups. Each square's attacks use the
+// same slots as in `tables.attacks`, but are ordered by
+// ExtractBits(occupied, mask) instead of by the magic index.
+std::vector<Bitboard> GeneratePextAttacks(const SlidingAttackTables &tables);
+
 }  // namespace follychess
 
 #endif  // FOLLYCHESS_ENGINE_MAGIC_H_
@@ -18,10 +18,12 @@
 #include <fstream>
 #include <iostream>
 #include <print>
+#include <vector>
 
 #include "magic.h"
 
 namespace {
+using ::follychess::Bitboard;
 using ::follychess::kNumSquares;
 using ::follychess::MagicEntry;
 using ::follychess::SlidingAttackTables;
@@ -45,7 +47,7 @@ void AddTable(std::ofstream& output) {
 
   std::println(output, "constexpr SlidingAttackTables kSliderAttacks = {{");
   std::println(output, "  .attacks = {{");
-  for (int i = 0; i < SlidingAttackTables::kAttackTableSize; ++i) {
+  for (std::size_t i = 0; i < SlidingAttackTables::kAttackTableSize; ++i) {
     std::println(output, "    Bitboard({}ULL),", table.attacks[i].Data());
   }
   std::println(output, "   }},");
@@ -62,6 +64,18 @@ void AddTable(std::ofstream& output) {
   }
   std::println(output, "  }},");
   std::println(output, "}};");
+  std::println(output);
+
+  std::vector<Bitboard> pext_attacks =
+      follychess::GeneratePextAttacks(table);
+  std::println(output,
+               "constexpr std::array<Bitboard, "
+               "SlidingAttackTables::kAttackTableSize>");
+  std::println(output, "    kPextSliderAttacks = {{");
+  for (Bitboard attacks : pext_attacks) {
+    std::println(output, "    Bitboard({}ULL),", attacks.Data());
+  }
+  std::println(output, "}};");
 }
 
 }  // namespace
@@ -58,6 +58,15 @@ class [[nodiscard]] Move {
 
   constexpr static Move NullMove() { return Move(); }
 
+  // Reconstructs a move from its raw encoding, as returned by `Data()`.
+  constexpr static Move FromData(std::uint16_t data) {
+    Move move;
+    move.data_ = data;
+    return move;
+  }
+
+  [[nodiscard]] constexpr std::uint16_t Data() const { return data_; }
+
   [[nodiscard]] constexpr Square GetFrom() const {
     DCHECK(!IsNullMove());
     return static_cast<Square>(data_ & 0b111111);
@@ -17,10 +17,11 @@
 
 #include "engine/move_generator.h"
 
-#include <vector>
-
 #include "absl/log/check.h"
 #include "engine/attacks.h"
+#include "engine/cpu.h"
+#include "engine/isa_dispatch.h"
+#include "engine/move_list.h"
 #include "engine/types.h"
 #include "line.h"
 
@@ -28,7 +29,7 @@ namespace follychess {
 namespace {
 
 void AddPawnMoves(Bitboard destinations, int offset, Move::Flags flag,
-                  std::vector<Move> &moves) {
+                  MoveList &moves) {
   while (destinations) {
     Square to = destinations.PopLeastSignificantBit();
     const auto from = static_cast<Square>(to - offset);
@@ -37,7 +38,7 @@ void AddPawnMoves(Bitboard destinations, int offset, Move::Flags flag,
 }
 
 void AddPawnPromotions(Bitboard promotions, int offset, Move::Flags flag,
-                       std::vector<Move> &moves) {
+                       MoveList &moves) {
   using enum Move::Flags;
 
   while (promotions) {
@@ -55,27 +56,30 @@ void AddPawnPromotions(Bitboard promotions, int offset, Move::Flags flag,
   }
 }
 
+// Generates the moves of `pawns` that land on `targets`. En passant captures
+// are generated separately by GenerateEnPassantCaptures().
 template <Side Side, MoveType MoveType>
-void GeneratePawnMoves(const Position &position, std::vector<Move> &moves) {
+void GeneratePawnMoves(const Position &position, Bitboard pawns,
+                       Bitboard targets, MoveList &moves) {
   static constexpr Direction forward = Side == kWhite ? kNorth : kSouth;
   static constexpr Bitboard promotion_rank =
       Side == kWhite ? rank::k8 : rank::k1;
-  Bitboard pawns = position.GetPieces(position.SideToMove(), kPawn);
 
   if constexpr (MoveType == kQuiet || MoveType == kEvasion) {
     Bitboard empty = ~position.GetPieces();
 
     // Single pawn pushes:
     Bitboard single_moves = pawns.Shift<forward>() & empty;
-    AddPawnMoves(single_moves & ~promotion_rank, forward, Move::Flags::kNone,
+    Bitboard single_targets = single_moves & targets;
+    AddPawnMoves(single_targets & ~promotion_rank, forward, Move::Flags::kNone,
                  moves);
-    AddPawnPromotions(single_moves & promotion_rank, forward,
+    AddPawnPromotions(single_targets & promotion_rank, forward,
                       Move::Flags::kNone, moves);
 
     // Double pawn pushes:
     Bitboard second_rank = Side == kWhite ? rank::k3 : rank::k6;
     Bitboard double_moves =
-        (single_moves & second_rank).Shift<forward>() & empty;
+        (single_moves & second_rank).Shift<forward>() & empty & targets;
     AddPawnMoves(double_moves, forward * 2, Move::Flags::kDoublePawnPush,
                  moves);
   }
@@ -84,7 +88,7 @@ void GeneratePawnMoves(const Position &position, std::vector<Move> &moves) {
     constexpr Direction left = Side == kWhite ? kNorthWest : kSouthEast;
     constexpr Direction right = Side == kWhite ? kNorthEast : kSouthWest;
 
-    Bitboard enemies = position.GetPieces(~Side);
+    Bitboard enemies = position.GetPieces(~Side) & targets;
 
     Bitboard left_captures = pawns.Shift<left>() & enemies;
     Bitboard right_captures = pawns.Shift<right>() & enemies;
@@ -94,15 +98,6 @@ void GeneratePawnMoves(const Position &position, std::vector<Move> &moves) {
     AddPawnMoves(right_captures & ~promotion_rank, right, Move::Flags::kCapture,
                  moves);
 
-    std::optional<Square> en_passant_target = position.GetEnPassantTarget();
-    if (en_passant_target) {
-      auto target = Bitboard(*en_passant_target);
-      AddPawnMoves(pawns.Shift<left>() & target, left,
-                   Move::Flags::kEnPassantCapture, moves);
-      AddPawnMoves(pawns.Shift<right>() & target, right,
-                   Move::Flags::kEnPassantCapture, moves);
-    }
-
     AddPawnPromotions(left_captures & promotion_rank, left,
                       Move::Flags::kCapture, moves);
     AddPawnPromotions(right_captures & promotion_rank, right,
@@ -110,14 +105,29 @@ void GeneratePawnMoves(const Position &position, std::vector<Move> &moves) {
   }
 }
 
-template <Side Side, Piece Piece>
-void GenerateMoves(const Position &position, Bitboard targets,
-                   std::vector<Move> &moves) {
-  Bitboard pieces = position.GetPieces(Side, Piece);
+template <Side Side>
+void GenerateEnPassantCaptures(const Position &position, MoveList &moves) {
+  const std::optional<Square> target = position.GetEnPassantTarget();
+  if (!target) {
+    return;
+  }
+
+  Bitboard pawns =
+      GetPawnAttacks(*target, ~Side) & position.GetPieces(Side, kPawn);
+  while (pawns) {
+    moves.emplace_back(pawns.PopLeastSignificantBit(), *target,
+                       Move::Flags::kEnPassantCapture);
+  }
+}
+
+template <Side Side, Piece Piece, typename SliderAttacks>
+void GenerateMoves(const Position &position, Bitboard pieces, Bitboard targets,
+                   MoveList &moves) {
   while (pieces) {
     Square from = pieces.PopLeastSignificantBit();
     Bitboard attacks =
-        GenerateAttacks<Piece>(from, position.GetPieces()) & targets;
+        GenerateAttacks<Piece, SliderAttacks>(from, position.GetPieces()) &
+        targets;
 
     while (attacks) {
       Square to = attacks.PopLeastSignificantBit();
@@ -147,7 +157,7 @@ template <Side Side>
 }
 
 template <Side Side>
-void GenerateCastlingMoves(const Position &position, std::vector<Move> &moves) {
+void GenerateCastlingMoves(const Position &position, MoveList &moves) {
   static_assert(Side == kWhite || Side == kBlack);
 
   if (position.GetCastlingRights().HasKingSide<Side>()) {
@@ -224,8 +234,8 @@ Bitboard GetKingTargets(const Position &position) {
   return {};
 }
 
-template <Side Side, MoveType MoveType>
-void GenerateMoves(const Position &position, std::vector<Move> &moves) {
+template <Side Side, MoveType MoveType, typename SliderAttacks>
+void GenerateMoves(const Position &position, MoveList &moves) {
   // Generate moves for all non-king pieces. This logic is shared for two
   // main scenarios:
   //
@@ -251,35 +261,90 @@ void GenerateMoves(const Position &position, std::vector<Move> &moves) {
       position.GetCheckers(Side).GetCount() == 1) {
     Bitboard targets = GetTargets<Side, MoveType>(position);
 
-    GeneratePawnMoves<Side, MoveType>(position, moves);
-    GenerateMoves<Side, kKnight>(position, targets, moves);
-    GenerateMoves<Side, kBishop>(position, targets, moves);
-    GenerateMoves<Side, kRook>(position, targets, moves);
-    GenerateMoves<Side, kQueen>(position, targets, moves);
+    GeneratePawnMoves<Side, MoveType>(
+        position, position.GetPieces(Side, kPawn), ~kEmptyBoard, moves);
+    if constexpr (MoveType == kCapture || MoveType == kEvasion) {
+      GenerateEnPassantCaptures<Side>(position, moves);
+    }
+    GenerateMoves<Side, kKnight, SliderAttacks>(
+        position, position.GetPieces(Side, kKnight), targets, moves);
+    GenerateMoves<Side, kBishop, SliderAttacks>(
+        position, position.GetPieces(Side, kBishop), targets, moves);
+    GenerateMoves<Side, kRook, SliderAttacks>(
+        position, position.GetPieces(Side, kRook), targets, moves);
+    GenerateMoves<Side, kQueen, SliderAttacks>(
+        position, position.GetPieces(Side, kQueen), targets, moves);
   }
 
-  GenerateMoves<Side, kKing>(position, GetKingTargets<Side, MoveType>(position),
-                             moves);
+  GenerateMoves<Side, kKing, SliderAttacks>(
+      position, position.GetPieces(Side, kKing),
+      GetKingTargets<Side, MoveType>(position), moves);
 
   if constexpr (MoveType == kQuiet) {
     GenerateCastlingMoves<Side>(position, moves);
   }
 }
 
+template <typename SliderAttacks>
+bool IsLegal(const Position &position, const Move move) {
+  const Side side = position.SideToMove();
+  const Square king = position.GetKing(side);
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+
+  // En passant removes two pieces from the board, which can expose the king
+  // along a rank, so these rare moves get the full check test.
+  if (move.IsEnPassantCapture()) {
+    Position new_position = position;
+    new_position.Do(move);
+    return !new_position.GetCheckers(side);
+  }
+
+  // The king must not step onto an attacked square. The king is removed from
+  // the occupancy so that it cannot hide behind itself from a slider.
+  if (from == king) {
+    return !position.GetAttackers(to, ~side,
+                                  position.GetPieces() ^ Bitboard(king));
+  }
+
+  // Any other move must capture or block a single checker.
+  if (const Bitboard checkers = position.GetCheckers(side)) {
+    if (checkers.GetCount() > 1) {
+      return false;
+    }
+    if (!((GetLine(checkers.LeastSignificantBit(), king) | checkers) & to)) {
+      return false;
+    }
+  }
+
+  // Finally, the move must not uncover a slider attack on the king, i.e., a
+  // pinned piece may only move along its pin ray.
+  const Bitboard occupied =
+      (position.GetPieces() ^ Bitboard(from)) | Bitboard(to);
+  const Bitboard enemies = position.GetPieces(~side) & ~Bitboard(to);
+  const Bitboard queens = position.GetPieces(kQueen);
+  return !(GenerateAttacks<kRook, SliderAttacks>(king, occupied) & enemies &
+           (position.GetPieces(kRook) | queens)) &&
+         !(GenerateAttacks<kBishop, SliderAttacks>(king, occupied) & enemies &
+           (position.GetPieces(kBishop) | queens));
+}
+
 }  // namespace
 
 template <MoveType MoveType>
-void GenerateMoves(const Position &position, std::vector<Move> &moves) {
-  if (position.SideToMove() == kWhite) {
-    GenerateMoves<kWhite, MoveType>(position, moves);
-  } else {
-    GenerateMoves<kBlack, MoveType>(position, moves);
-  }
+void GenerateMoves(const Position &position, MoveList &moves, const Isa isa) {
+  DispatchIsa(isa, [&]<typename SliderAttacks>() {
+    if (position.SideToMove() == kWhite) {
+      GenerateMoves<kWhite, MoveType, SliderAttacks>(position, moves);
+    } else {
+      GenerateMoves<kBlack, MoveType, SliderAttacks>(position, moves);
+    }
+  });
 }
 
 template <MoveType MoveType>
-std::vector<Move> GenerateMoves(const Position &position) {
-  std::vector<Move> moves;
+MoveList GenerateMoves(const Position &position) {
+  MoveList moves;
   GenerateMoves<MoveType>(position, moves);
   return moves;
 }
@@ -287,12 +352,18 @@ std::vector<Move> GenerateMoves(const Position &position) {
 // Explicitly instantiate the templates for `GenerateMoves()`.
 // This ensures the function is compiled and available to the linker, as the
 // template's definition is in this .cc file rather than a header.
-template std::vector<Move> GenerateMoves<kQuiet>(const Position &position);
-template std::vector<Move> GenerateMoves<kCapture>(const Position &position);
-template std::vector<Move> GenerateMoves<kEvasion>(const Position &position);
-
-std::vector<Move> GenerateMoves(const Position &position) {
-  std::vector<Move> moves;
+template void GenerateMoves<kQuiet>(const Position &position, MoveList &moves,
+                                    Isa isa);
+template void GenerateMoves<kCapture>(const Position &position,
+                                      MoveList &moves, Isa isa);
+template void GenerateMoves<kEvasion>(const Position &position,
+                                      MoveList &moves, Isa isa);
+template MoveList GenerateMoves<kQuiet>(const Position &position);
+template MoveList GenerateMoves<kCapture>(const Position &position);
+template MoveList GenerateMoves<kEvasion>(const Position &position);
+
+MoveList GenerateMoves(const Position &position) {
+  MoveList moves;
   if (position.GetCheckers(position.SideToMove())) {
     GenerateMoves<kEvasion>(position, moves);
   } else {
@@ -302,58 +373,178 @@ std::vector<Move> GenerateMoves(const Position &position) {
   return moves;
 }
 
+bool IsLegal(const Position &position, const Move move, const Isa isa) {
+  return DispatchIsa(isa, [&]<typename SliderAttacks>() {
+    return IsLegal<SliderAttacks>(position, move);
+  });
+}
+
 namespace {
 
-std::vector<Move> SelectLegalMoves(
-    const Position &position, const std::vector<Move> &pseudo_legal_moves) {
-  std::vector<Move> moves;
+MoveList SelectLegalMoves(const Position &position,
+                          const MoveList &pseudo_legal_moves) {
+  MoveList moves;
   for (Move move : pseudo_legal_moves) {
-    Position new_position = position;
-    new_position.Do(move);
-    if (!new_position.GetCheckers(~new_position.SideToMove())) {
+    if (IsLegal(position, move)) {
       moves.push_back(move);
     }
   }
   return moves;
 }
 
-}  // namespace
-
 template <Side Side>
-std::vector<Move> GenerateLegalMoves(Position position) {
-  if (position.SideToMove() != Side) {
-    position.Do(Move::NullMove());
+void GenerateLegalKingMoves(const Position &position, const Bitboard checkers,
+                            MoveList &moves) {
+  const Square king = position.GetKing(Side);
+  const Bitboard occupied = position.GetPieces() ^ Bitboard(king);
+
+  Bitboard attacks = GenerateAttacks<kKing>(king, occupied) &
+                     ~position.GetPieces(Side);
+  while (attacks) {
+    const Square to = attacks.PopLeastSignificantBit();
+    if (position.GetAttackers(to, ~Side, occupied)) {
+      continue;
+    }
+    moves.emplace_back(king, to,
+                       position.GetPiece(to) == kEmptyPiece
+                           ? Move::Flags::kNone
+                           : Move::Flags::kCapture);
   }
 
-  std::vector<Move> pseudo_legal_moves;
-  if (position.GetCheckers(position.SideToMove())) {
-    GenerateMoves<kEvasion>(position, pseudo_legal_moves);
-  } else {
-    GenerateMoves<kQuiet>(position, pseudo_legal_moves);
-    GenerateMoves<kCapture>(position, pseudo_legal_moves);
+  if (!checkers) {
+    GenerateCastlingMoves<Side>(position, moves);
+  }
+}
+
+// Generates the moves of the pinned piece on `from`, which may only move
+// along the `pin_ray` between its king and the pinner.
+template <Side Side, typename SliderAttacks>
+void GeneratePinnedMoves(const Position &position, const Square from,
+                         const Bitboard pin_ray, MoveList &moves) {
+  const Bitboard piece(from);
+  const Bitboard targets = pin_ray & ~position.GetPieces(Side);
+
+  switch (position.GetPiece(from)) {
+    case kPawn:
+      GeneratePawnMoves<Side, kQuiet>(position, piece, targets, moves);
+      GeneratePawnMoves<Side, kCapture>(position, piece, targets, moves);
+      break;
+    case kBishop:
+      GenerateMoves<Side, kBishop, SliderAttacks>(position, piece, targets,
+                                                  moves);
+      break;
+    case kRook:
+      GenerateMoves<Side, kRook, SliderAttacks>(position, piece, targets,
+                                                moves);
+      break;
+    case kQueen:
+      GenerateMoves<Side, kQueen, SliderAttacks>(position, piece, targets,
+                                                 moves);
+      break;
+    default:
+      // A pinned knight can never move.
+      break;
+  }
+}
+
+// Generates only legal moves. The check mask and the pinned pieces are
+// computed once, so that no move has to be played to test it, except for en
+// passant captures.
+template <Side Side, typename SliderAttacks>
+void GenerateLegalMoves(const Position &position, MoveList &moves) {
+  const Square king = position.GetKing(Side);
+  const Bitboard checkers = position.GetCheckers(Side);
+
+  GenerateLegalKingMoves<Side>(position, checkers, moves);
+
+  // In a double check, only the king can move.
+  if (checkers.GetCount() > 1) {
+    return;
+  }
+
+  // The squares that resolve a check: capturing the checker or, for sliders,
+  // blocking it.
+  Bitboard check_mask = ~kEmptyBoard;
+  if (checkers) {
+    check_mask = GetLine(checkers.LeastSignificantBit(), king) | checkers;
   }
 
-  return SelectLegalMoves(position, pseudo_legal_moves);
+  // Finds the enemy sliders that would attack the king if our own pieces were
+  // not in the way. Any of our pieces that is alone between such a slider and
+  // the king is pinned.
+  const Bitboard own = position.GetPieces(Side);
+  const Bitboard enemies = position.GetPieces(~Side);
+  const Bitboard queens = position.GetPieces(~Side, kQueen);
+  Bitboard snipers = (GenerateAttacks<kRook, SliderAttacks>(king, enemies) &
+                      (position.GetPieces(~Side, kRook) | queens)) |
+                     (GenerateAttacks<kBishop, SliderAttacks>(king, enemies) &
+                      (position.GetPieces(~Side, kBishop) | queens));
+
+  Bitboard pinned;
+  while (snipers) {
+    const Square sniper = snipers.PopLeastSignificantBit();
+    const Bitboard pin_ray = GetLine(sniper, king);
+    const Bitboard blockers = pin_ray & own;
+    if (blockers.GetCount() != 1) {
+      continue;
+    }
+
+    pinned |= blockers;
+
+    // A pinned piece cannot resolve a check by another piece, since it
+    // cannot leave the pin ray.
+    if (!checkers) {
+      GeneratePinnedMoves<Side, SliderAttacks>(
+          position, blockers.LeastSignificantBit(), pin_ray, moves);
+    }
+  }
+
+  const Bitboard targets = ~own & check_mask;
+  const Bitboard movable = own & ~pinned;
+
+  GeneratePawnMoves<Side, kQuiet>(position, movable & position.GetPieces(kPawn),
+                                  targets, moves);
+  GeneratePawnMoves<Side, kCapture>(
+      position, movable & position.GetPieces(kPawn), targets, moves);
+  GenerateMoves<Side, kKnight, SliderAttacks>(
+      position, movable & position.GetPieces(kKnight), targets, moves);
+  GenerateMoves<Side, kBishop, SliderAttacks>(
+      position, movable & position.GetPieces(kBishop), targets, moves);
+  GenerateMoves<Side, kRook, SliderAttacks>(
+      position, movable & position.GetPieces(kRook), targets, moves);
+  GenerateMoves<Side, kQueen, SliderAttacks>(
+      position, movable & position.GetPieces(kQueen), targets, moves);
+
+  MoveList en_passant_captures;
+  GenerateEnPassantCaptures<Side>(position, en_passant_captures);
+  for (const Move move : en_passant_captures) {
+    if (IsLegal<SliderAttacks>(position, move)) {
+      moves.push_back(move);
+    }
+  }
 }
 
+}  // namespace
+
 template <MoveType MoveType>
-std::vector<Move> GenerateLegalMoves(const Position &position) {
+MoveList GenerateLegalMoves(const Position &position) {
   return SelectLegalMoves(position, GenerateMoves<MoveType>(position));
 }
 
-template std::vector<Move> GenerateLegalMoves<kQuiet>(
-    const Position &position);
-template std::vector<Move> GenerateLegalMoves<kCapture>(
-    const Position &position);
-template std::vector<Move> GenerateLegalMoves<kEvasion>(
-    const Position &position);
-
-std::vector<Move> GenerateLegalMoves(const Position &position) {
-  if (position.SideToMove() == kWhite) {
-    return GenerateLegalMoves<kWhite>(position);
-  } else {
-    return GenerateLegalMoves<kBlack>(position);
-  }
+template MoveList GenerateLegalMoves<kQuiet>(const Position &position);
+template MoveList GenerateLegalMoves<kCapture>(const Position &position);
+template MoveList GenerateLegalMoves<kEvasion>(const Position &position);
+
+MoveList GenerateLegalMoves(const Position &position, const Isa isa) {
+  MoveList moves;
+  DispatchIsa(isa, [&]<typename SliderAttacks>() {
+    if (position.SideToMove() == kWhite) {
+      GenerateLegalMoves<kWhite, SliderAttacks>(position, moves);
+    } else {
+      GenerateLegalMoves<kBlack, SliderAttacks>(position, moves);
+    }
+  });
+  return moves;
 }
 
 }  // namespace follychess
@@ -18,18 +18,33 @@
 #ifndef FOLLYCHESS_MOVE_GENERATOR_H_
 #define FOLLYCHESS_MOVE_GENERATOR_H_
 
-#include <vector>
-
+#include "engine/cpu.h"
 #include "move.h"
+#include "move_list.h"
 #include "position.h"
 #include "types.h"
 
 namespace follychess {
 
+// Generates the pseudo-legal moves of the given type, i.e., moves that may
+// leave the king in check. Use IsLegal() to filter them.
+template <MoveType MoveType>
+MoveList GenerateMoves(const Position &position);
+
+// Like above, but appends the moves to `moves`. `isa` selects the variant of
+// the code to run, which the CPU must support. All variants generate the same
+// moves.
+template <MoveType MoveType>
+void GenerateMoves(const Position &position, MoveList &moves,
+                   Isa isa = GetBestIsa());
+
+// Returns whether the pseudo-legal `move` does not leave the king in check.
+bool IsLegal(const Position &position, Move move, Isa isa = GetBestIsa());
+
 template <MoveType MoveType>
-std::vector<Move> GenerateLegalMoves(const Position &position);
+MoveList GenerateLegalMoves(const Position &position);
 
-std::vector<Move> GenerateLegalMoves(const Position &position);
+MoveList GenerateLegalMoves(const Position &position, Isa isa = GetBestIsa());
 
 }  // namespace follychess
 
@@ -20,6 +20,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <string_view>
+#include <vector>
+
+#include "engine/cpu.h"
+#include "engine/move_list.h"
 #include "engine/position.h"
 #include "engine/testing.h"
 
@@ -28,6 +33,7 @@ namespace {
 
 using ::testing::AllOf;
 using ::testing::Contains;
+using ::testing::ElementsAreArray;
 using ::testing::Eq;
 using ::testing::IsEmpty;
 using ::testing::Not;
@@ -975,5 +981,156 @@ TEST(Evasion, CheckResolvedViaKnightCapture) {
   EXPECT_THAT(GenerateLegalMoves<kEvasion>(position), Contains(MakeMove("g6f7#c")));
 }
 
+TEST(IsLegal, PinnedPiece) {
+  Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . r . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . B . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(GenerateMoves<kQuiet>(position), Contains(MakeMove("e2d3")));
+  EXPECT_FALSE(IsLegal(position, MakeMove("e2d3")));
+  EXPECT_TRUE(IsLegal(position, MakeMove("e1d1")));
+}
+
+TEST(GenerateLegalMoves, PinnedPieces) {
+  Position position = MakePosition(
+      "8: . . . . r . . k"
+      "7: . . . . . . . ."
+      "6: . . . . R . . ."
+      "5: b . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . N . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(GenerateLegalMoves(position),
+              UnorderedElementsAreArray(MakeMoves({
+                  "e6e7",
+                  "e6e5",
+                  "e6e4",
+                  "e6e3",
+                  "e6e2",
+                  "e6e8#c",
+                  "e1d1",
+                  "e1e2",
+                  "e1f1",
+                  "e1f2",
+              })));
+}
+
+TEST(GenerateLegalMoves, KingCannotRetreatAlongCheckingRay) {
+  Position position = MakePosition(
+      "8: . . . . . . . k"
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: r . . . K . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . . . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(GenerateLegalMoves(position),
+              UnorderedElementsAreArray(MakeMoves({
+                  "e4d5",
+                  "e4e5",
+                  "e4f5",
+                  "e4d3",
+                  "e4e3",
+                  "e4f3",
+              })));
+}
+
+TEST(GenerateLegalMoves, EnPassantExposesKing) {
+  Position position = MakePosition(
+      "8: . . . . . . . k"
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: K . . P p . . r"
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . . . . ."
+      "   a b c d e f g h"
+      //
+      "   w - e6 0 1");
+
+  EXPECT_THAT(GenerateLegalMoves(position), Contains(MakeMove("d5d6")));
+  EXPECT_THAT(GenerateLegalMoves(position),
+              Not(Contains(MakeMove("d5e6#ep"))));
+}
+
+constexpr std::string_view kPerftFens[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+};
+
+TEST(GenerateLegalMoves, MatchesFilteredPseudoLegalMoves) {
+  for (const std::string_view fen : kPerftFens) {
+    Position position = Position::FromFen(fen).value();
+
+    MoveList pseudo_legal_moves;
+    GenerateMoves<kQuiet>(position, pseudo_legal_moves);
+    GenerateMoves<kCapture>(position, pseudo_legal_moves);
+    std::vector<Move> expected;
+    for (const Move move : pseudo_legal_moves) {
+      Position new_position = position;
+      new_position.Do(move);
+      if (!new_position.GetCheckers(position.SideToMove())) {
+        expected.push_back(move);
+      }
+    }
+
+    EXPECT_THAT(GenerateLegalMoves(position),
+                UnorderedElementsAreArray(expected))
+        << fen;
+  }
+}
+
+TEST(GenerateLegalMoves, SameMovesForEveryIsa) {
+  for (const Isa isa : {Isa::kPopcnt, Isa::kBmi2}) {
+    if (!IsSupported(isa)) {
+      continue;
+    }
+    for (const std::string_view fen : kPerftFens) {
+      const Position position = Position::FromFen(fen).value();
+
+      MoveList expected;
+      GenerateMoves<kQuiet>(position, expected, Isa::kGeneric);
+      GenerateMoves<kCapture>(position, expected, Isa::kGeneric);
+      MoveList moves;
+      GenerateMoves<kQuiet>(position, moves, isa);
+      GenerateMoves<kCapture>(position, moves, isa);
+      EXPECT_THAT(moves, ElementsAreArray(expected)) << ToString(isa) << " " << fen;
+
+      for (const Move move : expected) {
+        EXPECT_THAT(IsLegal(position, move, isa),
+                    Eq(IsLegal(position, move, Isa::kGeneric)))
+            << ToString(isa) << " " << fen << " " << move;
+      }
+
+      EXPECT_THAT(GenerateLegalMoves(position, isa),
+                  ElementsAreArray(GenerateLegalMoves(position, Isa::kGeneric)))
+          << ToString(isa) << " " << fen;
+    }
+  }
+}
+
 }  // namespace
 }  // namespace follychess
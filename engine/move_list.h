@@ -0,0 +1,85 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_ENGINE_MOVE_LIST_H_
+#define FOLLYCHESS_ENGINE_MOVE_LIST_H_
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "engine/move.h"
+
+namespace follychess {
+
+// A list of moves with inline storage, so that generating moves never touches
+// the heap. No position has more than 218 legal moves, and the pseudo-legal
+// moves stay within the capacity as well.
+class MoveList {
+ public:
+  using value_type = Move;
+  using size_type = std::size_t;
+  using iterator = Move *;
+  using const_iterator = const Move *;
+
+  static constexpr std::size_t kCapacity = 256;
+
+  // The storage is left uninitialized, since only the first size() moves are
+  // ever read.
+  MoveList() {}
+
+  void push_back(const Move move) {
+    DCHECK_LT(size_, kCapacity);
+    moves_[size_++] = move;
+  }
+
+  template <typename... Args>
+  void emplace_back(Args &&...args) {
+    push_back(Move(std::forward<Args>(args)...));
+  }
+
+  void clear() { size_ = 0; }
+
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  [[nodiscard]] Move &operator[](const std::size_t index) {
+    DCHECK_LT(index, size_);
+    return moves_[index];
+  }
+
+  [[nodiscard]] const Move &operator[](const std::size_t index) const {
+    DCHECK_LT(index, size_);
+    return moves_[index];
+  }
+
+  [[nodiscard]] iterator begin() { return moves_.data(); }
+  [[nodiscard]] iterator end() { return moves_.data() + size_; }
+  [[nodiscard]] const_iterator begin() const { return moves_.data(); }
+  [[nodiscard]] const_iterator end() const { return moves_.data() + size_; }
+
+ private:
+  std::size_t size_ = 0;
+  union {
+    std::array<Move, kCapacity> moves_;
+  };
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_ENGINE_MOVE_LIST_H_
@@ -0,0 +1,72 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "engine/move_list.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "engine/move.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+
+TEST(MoveList, Empty) {
+  MoveList moves;
+  EXPECT_THAT(moves, IsEmpty());
+  EXPECT_THAT(moves.begin(), Eq(moves.end()));
+}
+
+TEST(MoveList, PushBack) {
+  MoveList moves;
+  moves.push_back(Move(E2, E4, Move::kDoublePawnPush));
+  moves.emplace_back(G1, F3);
+
+  EXPECT_THAT(moves, ElementsAre(Move(E2, E4, Move::kDoublePawnPush),
+                                 Move(G1, F3)));
+  EXPECT_THAT(moves[1], Eq(Move(G1, F3)));
+
+  moves.clear();
+  EXPECT_THAT(moves, IsEmpty());
+}
+
+TEST(MoveList, Capacity) {
+  MoveList moves;
+  for (std::size_t i = 0; i < MoveList::kCapacity; ++i) {
+    moves.emplace_back(A1, B1);
+  }
+  EXPECT_THAT(moves, SizeIs(MoveList::kCapacity));
+}
+
+TEST(MoveList, Copy) {
+  MoveList moves;
+  moves.emplace_back(A1, B1);
+
+  MoveList copy = moves;
+  copy.emplace_back(B1, C1);
+
+  EXPECT_THAT(moves, SizeIs(1));
+  EXPECT_THAT(copy, ElementsAre(Move(A1, B1), Move(B1, C1)));
+}
+
+}  // namespace
+}  // namespace follychess
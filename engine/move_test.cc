@@ -43,6 +43,13 @@ TEST(Move, Null) {
   EXPECT_THAT(move.IsPromotion(), IsFalse());
 }
 
+TEST(Move, Data) {
+  EXPECT_THAT(Move::FromData(Move::NullMove().Data()), Eq(Move::NullMove()));
+
+  Move move(E7, F8, Move::Flags::kQueenPromotionCapture);
+  EXPECT_THAT(Move::FromData(move.Data()), Eq(move));
+}
+
 TEST(Move, NonPromotion) {
   Move move(A1, B2);
 
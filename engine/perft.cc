@@ -24,6 +24,7 @@
 
 #include "move.h"
 #include "move_generator.h"
+#include "move_list.h"
 #include "position.h"
 #include "scoped_move.h"
 
@@ -39,7 +40,7 @@ std::size_t RunPerft(std::size_t depth, std::size_t current_depth,
     return 1;
   }
 
-  std::vector<Move> moves = GenerateLegalMoves(position);
+  MoveList moves = GenerateLegalMoves(position);
   std::size_t final_move_count = 0;
 
   for (const Move &move : moves) {
@@ -60,7 +61,7 @@ void RunPerft(std::size_t depth, const Position &position,
     return;
   }
 
-  std::vector<Move> initial_moves = GenerateLegalMoves(position);
+  MoveList initial_moves = GenerateLegalMoves(position);
 
   std::vector<std::vector<std::size_t>> all_depth_counts(
       initial_moves.size(), std::vector<std::size_t>(depth + 1, 0));
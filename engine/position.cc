@@ -53,37 +53,11 @@ namespace {
 
 }  // namespace
 
-Piece Position::GetPiece(Square square) const {
-  if (pieces_[kPawn] & square) {
-    return kPawn;
-  }
-  if (pieces_[kKnight] & square) {
-    return kKnight;
-  }
-  if (pieces_[kBishop] & square) {
-    return kBishop;
-  }
-  if (pieces_[kRook] & square) {
-    return kRook;
-  }
-  if (pieces_[kQueen] & square) {
-    return kQueen;
-  }
-  if (pieces_[kKing] & square) {
-    return kKing;
-  }
-
-  return kEmptyPiece;
-}
-
 Side Position::GetSide(Square square) const {
-  if (sides_[kWhite] & square) {
-    return kWhite;
-  }
-  if (sides_[kBlack] & square) {
-    return kBlack;
+  if (board_[square] == kEmptyPiece) {
+    return kEmptySide;
   }
-  return kEmptySide;
+  return sides_[kWhite] & square ? kWhite : kBlack;
 }
 
 Bitboard Position::GetPieces() const { return sides_[kWhite] | sides_[kBlack]; }
@@ -97,7 +71,11 @@ Bitboard Position::GetPieces(Side side, Piece type) const {
 }
 
 Bitboard Position::GetAttackers(Square to, Side attacker_side) const {
-  Bitboard occupied = GetPieces();
+  return GetAttackers(to, attacker_side, GetPieces());
+}
+
+Bitboard Position::GetAttackers(Square to, Side attacker_side,
+                                Bitboard occupied) const {
   Bitboard attackers;
 
   Side victim_side = ~attacker_side;
@@ -253,6 +231,7 @@ std::expected<Position, std::string> Position::FromFen(
       !result.has_value()) {
     return std::unexpected(result.error());
   }
+  position.InitBoard();
 
   if (side_to_move == "w") {
     position.side_to_move_ = kWhite;
@@ -305,10 +284,13 @@ UndoInfo Position::Do(const Move &move) {
       .castling_rights = castling_rights_,
   };
 
+  // The target is only hashed if the side to move can capture on it, so it is
+  // removed from the key before any pawn moves or is captured.
+  zobrist_key_.ToggleEnPassantTarget(
+      GetHashedEnPassantTarget(en_passant_target_, side_to_move_));
+
   if (move.IsNullMove()) {
-    zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
     en_passant_target_ = std::nullopt;
-    zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
 
     side_to_move_ = ~side_to_move_;
     zobrist_key_.UpdateSideToMove();
@@ -324,7 +306,7 @@ UndoInfo Position::Do(const Move &move) {
     pieces_[undo_info.captured_piece].Clear(move.GetTo());
     sides_[~side_to_move_].Clear(move.GetTo());
     half_moves_ = 0;
-    zobrist_key_.Update(move.GetTo(), undo_info.captured_piece, ~side_to_move_);
+    UpdatePieceKeys(move.GetTo(), undo_info.captured_piece, ~side_to_move_);
   }
 
   Piece piece = GetPiece(move.GetFrom());
@@ -333,14 +315,15 @@ UndoInfo Position::Do(const Move &move) {
     half_moves_ = 0;
   }
 
-  zobrist_key_.Update(move.GetFrom(), piece, side_to_move_);
-  zobrist_key_.Update(move.GetTo(), piece, side_to_move_);
+  UpdatePieceKeys(move.GetFrom(), piece, side_to_move_);
+  UpdatePieceKeys(move.GetTo(), piece, side_to_move_);
 
   if (move.IsEnPassantCapture()) {
     Square en_passant_victim = move.GetEnPassantVictim();
     pieces_[kPawn].Clear(en_passant_victim);
     sides_[~side_to_move_].Clear(en_passant_victim);
-    zobrist_key_.Update(en_passant_victim, kPawn, ~side_to_move_);
+    board_[en_passant_victim] = kEmptyPiece;
+    UpdatePieceKeys(en_passant_victim, kPawn, ~side_to_move_);
     half_moves_ = 0;
   }
 
@@ -351,11 +334,15 @@ UndoInfo Position::Do(const Move &move) {
   DCHECK(side != kEmptySide);
   sides_[side] ^= from_to;
 
+  board_[move.GetFrom()] = kEmptyPiece;
+  board_[move.GetTo()] = piece;
+
   if (move.IsPromotion()) {
     pieces_[kPawn].Clear(move.GetTo());
     pieces_[move.GetPromotedPiece()].Set(move.GetTo());
-    zobrist_key_.Update(move.GetTo(), kPawn, side_to_move_);
-    zobrist_key_.Update(move.GetTo(), move.GetPromotedPiece(), side_to_move_);
+    board_[move.GetTo()] = move.GetPromotedPiece();
+    UpdatePieceKeys(move.GetTo(), kPawn, side_to_move_);
+    UpdatePieceKeys(move.GetTo(), move.GetPromotedPiece(), side_to_move_);
   }
 
   // Non-empty if and only if the move is a castling move.
@@ -367,7 +354,8 @@ UndoInfo Position::Do(const Move &move) {
   sides_[side] ^= rook_mask;
   while (rook_mask) {
     Square square = rook_mask.PopLeastSignificantBit();
-    zobrist_key_.Update(square, kRook, side_to_move_);
+    board_[square] = board_[square] == kRook ? kEmptyPiece : kRook;
+    UpdatePieceKeys(square, kRook, side_to_move_);
   }
 
   zobrist_key_.ToggleCastlingRights(castling_rights_);
@@ -381,10 +369,10 @@ UndoInfo Position::Do(const Move &move) {
   side_to_move_ = ~side_to_move_;
   zobrist_key_.UpdateSideToMove();
 
-  zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
   if (move.IsDoublePawnPush()) {
     en_passant_target_ = move.GetEnPassantTarget();
-    zobrist_key_.ToggleEnPassantTarget(move.GetEnPassantTarget());
+    zobrist_key_.ToggleEnPassantTarget(
+        GetHashedEnPassantTarget(en_passant_target_, side_to_move_));
   } else {
     en_passant_target_ = std::nullopt;
   }
@@ -392,17 +380,66 @@ UndoInfo Position::Do(const Move &move) {
   return undo_info;
 }
 
+ZobristKey Position::GetKeyAfter(const Move &move) const {
+  ZobristKey key = zobrist_key_;
+  key.UpdateSideToMove();
+  key.ToggleEnPassantTarget(
+      GetHashedEnPassantTarget(en_passant_target_, side_to_move_));
+
+  if (move.IsNullMove()) {
+    return key;
+  }
+
+  if (const Piece captured = GetPiece(move.GetTo()); captured != kEmptyPiece) {
+    key.Update(move.GetTo(), captured, ~side_to_move_);
+  }
+  if (move.IsEnPassantCapture()) {
+    key.Update(move.GetEnPassantVictim(), kPawn, ~side_to_move_);
+  }
+
+  const Piece piece = GetPiece(move.GetFrom());
+  DCHECK(piece != kEmptyPiece);
+  key.Update(move.GetFrom(), piece, side_to_move_);
+  if (move.IsPromotion()) {
+    key.Update(move.GetTo(), move.GetPromotedPiece(), side_to_move_);
+  } else {
+    key.Update(move.GetTo(), piece, side_to_move_);
+  }
+
+  Bitboard rook_mask = GetCastlingRookMask(move, side_to_move_);
+  while (rook_mask) {
+    key.Update(rook_mask.PopLeastSignificantBit(), kRook, side_to_move_);
+  }
+
+  CastlingRights castling_rights = castling_rights_;
+  key.ToggleCastlingRights(castling_rights);
+  castling_rights.InvalidateOnMove(move.GetFrom());
+  castling_rights.InvalidateOnMove(move.GetTo());
+  key.ToggleCastlingRights(castling_rights);
+
+  // A double push moves neither the pawns of the opponent, who can capture
+  // on the target, nor any other pawn.
+  if (move.IsDoublePawnPush()) {
+    key.ToggleEnPassantTarget(
+        GetHashedEnPassantTarget(move.GetEnPassantTarget(), ~side_to_move_));
+  }
+
+  return key;
+}
+
 void Position::Undo(const UndoInfo &undo_info) {
   const Move &move = undo_info.move;
 
+  zobrist_key_.ToggleEnPassantTarget(
+      GetHashedEnPassantTarget(en_passant_target_, side_to_move_));
+  en_passant_target_ = undo_info.en_passant_target;
+
   side_to_move_ = ~side_to_move_;
   zobrist_key_.UpdateSideToMove();
 
-  zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
-  en_passant_target_ = undo_info.en_passant_target;
-  zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
-
   if (move.IsNullMove()) {
+    zobrist_key_.ToggleEnPassantTarget(
+        GetHashedEnPassantTarget(en_passant_target_, side_to_move_));
     return;
   }
 
@@ -413,16 +450,17 @@ void Position::Undo(const UndoInfo &undo_info) {
   if (move.IsPromotion()) {
     pieces_[move.GetPromotedPiece()].Clear(move.GetTo());
     pieces_[kPawn].Set(move.GetTo());
-    zobrist_key_.Update(move.GetTo(), kPawn, side_to_move_);
-    zobrist_key_.Update(move.GetTo(), move.GetPromotedPiece(), side_to_move_);
+    board_[move.GetTo()] = kPawn;
+    UpdatePieceKeys(move.GetTo(), kPawn, side_to_move_);
+    UpdatePieceKeys(move.GetTo(), move.GetPromotedPiece(), side_to_move_);
   }
 
   Bitboard from_to = Bitboard(move.GetFrom()) | Bitboard(move.GetTo());
 
   Piece piece = GetPiece(move.GetTo());
   DCHECK(piece != kEmptyPiece);
-  zobrist_key_.Update(move.GetFrom(), piece, side_to_move_);
-  zobrist_key_.Update(move.GetTo(), piece, side_to_move_);
+  UpdatePieceKeys(move.GetFrom(), piece, side_to_move_);
+  UpdatePieceKeys(move.GetTo(), piece, side_to_move_);
 
   pieces_[piece] ^= from_to;
 
@@ -430,18 +468,23 @@ void Position::Undo(const UndoInfo &undo_info) {
   DCHECK(side != kEmptySide);
   sides_[side] ^= from_to;
 
+  board_[move.GetFrom()] = piece;
+  board_[move.GetTo()] = kEmptyPiece;
+
   if (move.IsEnPassantCapture()) {
     Square en_passant_victim = move.GetEnPassantVictim();
     pieces_[kPawn].Set(move.GetEnPassantVictim());
     sides_[~side].Set(move.GetEnPassantVictim());
-    zobrist_key_.Update(en_passant_victim, kPawn, ~side_to_move_);
+    board_[en_passant_victim] = kPawn;
+    UpdatePieceKeys(en_passant_victim, kPawn, ~side_to_move_);
   }
 
   if (undo_info.captured_piece != kEmptyPiece) {
     // Restores a non-passant captured piece.
     pieces_[undo_info.captured_piece].Set(move.GetTo());
     sides_[~side].Set(move.GetTo());
-    zobrist_key_.Update(move.GetTo(), undo_info.captured_piece, ~side);
+    board_[move.GetTo()] = undo_info.captured_piece;
+    UpdatePieceKeys(move.GetTo(), undo_info.captured_piece, ~side);
   }
 
   // Non-empty if and only if the move is a castling move.
@@ -451,13 +494,37 @@ void Position::Undo(const UndoInfo &undo_info) {
   sides_[side] ^= rook_mask;
   while (rook_mask) {
     Square square = rook_mask.PopLeastSignificantBit();
-    zobrist_key_.Update(square, kRook, side_to_move_);
+    board_[square] = board_[square] == kRook ? kEmptyPiece : kRook;
+    UpdatePieceKeys(square, kRook, side_to_move_);
   }
 
   if (side == kBlack) {
     --full_moves_;
   }
   half_moves_ = undo_info.half_moves;
+
+  // The restored target depends on the pawns, which are back in place now.
+  zobrist_key_.ToggleEnPassantTarget(
+      GetHashedEnPassantTarget(en_passant_target_, side_to_move_));
+}
+
+std::optional<Square> Position::GetHashedEnPassantTarget(
+    const std::optional<Square> target, const Side side) const {
+  if (target &&
+      GetPawnAttacks(*target, ~side) & pieces_[kPawn] & sides_[side]) {
+    return target;
+  }
+  return std::nullopt;
+}
+
+void Position::InitBoard() {
+  board_.fill(kEmptyPiece);
+  for (int piece = kPawn; piece < kNumPieces; ++piece) {
+    Bitboard squares = pieces_[piece];
+    while (squares) {
+      board_[squares.PopLeastSignificantBit()] = static_cast<Piece>(piece);
+    }
+  }
 }
 
 void Position::InitKey() {
@@ -468,14 +535,15 @@ void Position::InitKey() {
       continue;
     }
 
-    zobrist_key_.Update(square, piece, GetSide(square));
+    UpdatePieceKeys(square, piece, GetSide(square));
   }
 
-  if (side_to_move_ == kBlack) {
+  if (side_to_move_ == kWhite) {
     zobrist_key_.UpdateSideToMove();
   }
 
-  zobrist_key_.ToggleEnPassantTarget(en_passant_target_);
+  zobrist_key_.ToggleEnPassantTarget(
+      GetHashedEnPassantTarget(en_passant_target_, side_to_move_));
   zobrist_key_.ToggleCastlingRights(castling_rights_);
 }
 
@@ -18,8 +18,10 @@
 #ifndef FOLLYCHESS_POSITION_H_
 #define FOLLYCHESS_POSITION_H_
 
+#include <array>
 #include <expected>
 #include <format>
+#include <optional>
 #include <string_view>
 
 #include "engine/bitboard.h"
@@ -44,7 +46,7 @@ class Position {
       const std::vector<std::string_view> &fen_parts);
 
   // Returns the piece at the given square.
-  [[nodiscard]] Piece GetPiece(Square square) const;
+  [[nodiscard]] Piece GetPiece(Square square) const { return board_[square]; }
 
   // Returns the side at the given square.
   [[nodiscard]] Side GetSide(Square square) const;
@@ -65,6 +67,11 @@ class Position {
   // Returns all pieces that attack the given square.
   [[nodiscard]] Bitboard GetAttackers(Square to, Side by) const;
 
+  // Like above, but computes slider attacks as if the board had the given
+  // occupancy.
+  [[nodiscard]] Bitboard GetAttackers(Square to, Side by,
+                                      Bitboard occupied) const;
+
   // Returns the king for the side to move.
   [[nodiscard]] Square GetKing(Side side) const;
 
@@ -91,18 +98,50 @@ class Position {
 
   [[nodiscard]] ZobristKey GetKey() const { return zobrist_key_; }
 
+  // Returns a key that only covers the pawns of both sides, e.g., for caching
+  // evaluation terms that depend on the pawn structure alone.
+  [[nodiscard]] ZobristKey GetPawnKey() const { return pawn_key_; }
+
+  // Returns the key the position would have after `move`, without making the
+  // move. This is cheap enough to call before every move, e.g., to prefetch
+  // the child's transposition table entry.
+  [[nodiscard]] ZobristKey GetKeyAfter(const Move &move) const;
+
  private:
   Position()
       : side_to_move_(kWhite),
         en_passant_target_(std::nullopt),
         half_moves_(0),
-        full_moves_(1) {}
+        full_moves_(1) {
+    board_.fill(kEmptyPiece);
+  }
+
+  void InitBoard();
 
   void InitKey();
 
+  // Returns `target` if a pawn of `side` can capture en passant on it, and
+  // nullopt otherwise. Like Polyglot, only such targets are hashed, so that
+  // positions that only differ by an unusable target share a key.
+  [[nodiscard]] std::optional<Square> GetHashedEnPassantTarget(
+      std::optional<Square> target, Side side) const;
+
+  // Updates the keys for adding or removing `piece` on `square`.
+  void UpdatePieceKeys(const Square square, const Piece piece,
+                       const Side side) {
+    zobrist_key_.Update(square, piece, side);
+    if (piece == kPawn) {
+      pawn_key_.Update(square, piece, side);
+    }
+  }
+
   std::array<Bitboard, kNumPieces> pieces_ = {};
   std::array<Bitboard, kNumSides> sides_ = {};
 
+  // The piece on each square, kept in sync with `pieces_` so that
+  // GetPiece() is a single lookup.
+  std::array<Piece, kNumSquares> board_;
+
   Side side_to_move_;
   CastlingRights castling_rights_;
 
@@ -112,6 +151,7 @@ class Position {
   int full_moves_;
 
   ZobristKey zobrist_key_;
+  ZobristKey pawn_key_;
 };
 
 }  // namespace follychess
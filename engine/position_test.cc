@@ -20,9 +20,12 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <expected>
 
+#include "engine/move_generator.h"
 #include "engine/testing.h"
+#include "engine/zobrist.h"
 #include "scoped_move.h"
 
 namespace follychess {
@@ -241,6 +244,33 @@ TEST(Position, DoAndUndo) {
   EXPECT_THAT(position, EqualsPosition(kStartingPosition));
 }
 
+TEST(Position, PawnKey) {
+  Position position = Position::Starting();
+  const ZobristKey key = position.GetKey();
+  const ZobristKey pawn_key = position.GetPawnKey();
+
+  UndoInfo knight_move = position.Do(Move(B1, C3));
+  EXPECT_THAT(position.GetKey(), Not(Eq(key)));
+  EXPECT_THAT(position.GetPawnKey(), Eq(pawn_key));
+
+  UndoInfo pawn_move = position.Do(Move(D7, D5, Move::Flags::kDoublePawnPush));
+  EXPECT_THAT(position.GetPawnKey(), Not(Eq(pawn_key)));
+
+  UndoInfo capture = position.Do(Move(C3, D5, Move::Flags::kCapture));
+  // Only the pawns contribute to the pawn key.
+  const Position pawns_only =
+      Position::FromFen("4k3/ppp1pppp/8/8/8/8/PPPPPPPP/4K3 w - - 0 1").value();
+  EXPECT_THAT(position.GetPawnKey(), Eq(pawns_only.GetPawnKey()));
+  EXPECT_THAT(position.GetKey(), Not(Eq(pawns_only.GetKey())));
+
+  position.Undo(capture);
+  position.Undo(pawn_move);
+  EXPECT_THAT(position.GetPawnKey(), Eq(pawn_key));
+
+  position.Undo(knight_move);
+  EXPECT_THAT(position.GetKey(), Eq(key));
+}
+
 TEST(GetPieces, StartingPosition) {
   Position position = Position::Starting();
 
@@ -1322,6 +1352,114 @@ TEST(Position, Key) {
   EXPECT_THAT(position.GetKey(), Eq(v0));
 }
 
+TEST(Position, KeyFollowsPolyglot) {
+  // Polyglot's definition of the key of the starting position: the pieces,
+  // all four castling rights and white to move.
+  const Position position = Position::Starting();
+  std::uint64_t expected = kRandom64[kPolyglotTurnOffset];
+  for (int right = 0; right < 4; ++right) {
+    expected ^= kRandom64[kPolyglotCastlingOffset + right];
+  }
+  for (int i = 0; i < kNumSquares; ++i) {
+    const auto square = static_cast<Square>(i);
+    if (position.GetPiece(square) != kEmptyPiece) {
+      expected ^= kRandom64[GetPolyglotPieceIndex(
+          square, position.GetPiece(square), position.GetSide(square))];
+    }
+  }
+
+  EXPECT_THAT(position.GetKey().GetValue(), Eq(expected));
+}
+
+TEST(Position, KeyOnlyHashesCapturableEnPassantTargets) {
+  // Like Polyglot, an en passant target only changes the key if a pawn of the
+  // side to move can capture on it.
+  Position position = Position::Starting();
+  ScopedMove push(Move(E2, E4), position);
+  EXPECT_THAT(
+      position.GetKey(),
+      Eq(Position::FromFen(
+             "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1")
+             .value()
+             .GetKey()));
+
+  EXPECT_THAT(
+      Position::FromFen(
+          "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3")
+          .value()
+          .GetKey(),
+      Not(Eq(Position::FromFen(
+                 "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 3")
+                 .value()
+                 .GetKey())));
+}
+
+TEST(Position, KeyIsReproducible) {
+  // The keys are generated at compile time from a fixed seed, so they can be
+  // persisted and compared between runs.
+  EXPECT_THAT(Position::Starting().GetKey().GetValue(),
+              Eq(10155291015552892003ULL));
+}
+
+TEST(Position, GetKeyAfter) {
+  constexpr std::array<std::string_view, 3> kFens = {
+      // Kiwipete: castling, captures and en passant targets.
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      // An en passant capture is available.
+      "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+      // Promotions, including captures that remove castling rights.
+      "r3k2r/1P4P1/8/8/8/8/1p4p1/R3K2R b KQkq - 0 1",
+  };
+
+  for (std::string_view fen : kFens) {
+    Position position = Position::FromFen(fen).value();
+    for (const Move move : GenerateLegalMoves(position)) {
+      const ZobristKey expected = position.GetKeyAfter(move);
+      ScopedMove scoped_move(move, position);
+      EXPECT_THAT(position.GetKey(), Eq(expected)) << fen << " " << move;
+    }
+
+    const ZobristKey expected = position.GetKeyAfter(Move::NullMove());
+    ScopedMove scoped_move(Move::NullMove(), position);
+    EXPECT_THAT(position.GetKey(), Eq(expected)) << fen;
+  }
+}
+
+TEST(Position, GetPieceMatchesBitboards) {
+  constexpr std::array<std::string_view, 3> kFens = {
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+      "r3k2r/1P4P1/8/8/8/8/1p4p1/R3K2R b KQkq - 0 1",
+  };
+
+  auto expect_consistent = [](const Position &position) {
+    for (int i = 0; i < kNumSquares; ++i) {
+      const auto square = static_cast<Square>(i);
+      Piece expected = kEmptyPiece;
+      for (int piece = kPawn; piece < kNumPieces; ++piece) {
+        if (position.GetPieces(static_cast<Piece>(piece)) & square) {
+          expected = static_cast<Piece>(piece);
+        }
+      }
+      EXPECT_THAT(position.GetPiece(square), Eq(expected));
+    }
+  };
+
+  for (std::string_view fen : kFens) {
+    Position position = Position::FromFen(fen).value();
+    const Position original = position;
+    expect_consistent(position);
+
+    for (const Move move : GenerateLegalMoves(position)) {
+      {
+        ScopedMove scoped_move(move, position);
+        expect_consistent(position);
+      }
+      EXPECT_THAT(position, Eq(original)) << fen << " " << move;
+    }
+  }
+}
+
 TEST(HalfMoveClock, ResetsOnPawnMovesAndCaptures) {
   // Quiet move:
   {
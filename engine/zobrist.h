@@ -18,58 +18,119 @@
 #ifndef FOLLYCHESS_ZOBRIST_H_
 #define FOLLYCHESS_ZOBRIST_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
-#include <random>
-#include <tuple>
 
 #include "engine/castling.h"
 #include "engine/types.h"
 
 namespace follychess {
 
-struct ZobristKeys {
-  ZobristKeys();
+// A xorshift64* generator (https://vigna.di.unimi.it/ftp/papers/xorshift.pdf)
+// that can run at compile time, so that the keys below are the same in every
+// process and every build.
+class ZobristRandom {
+ public:
+  explicit constexpr ZobristRandom(std::uint64_t seed) : state_(seed) {}
+
+  constexpr std::uint64_t Next() {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 2685821657736338717ULL;
+  }
+
+ private:
+  std::uint64_t state_;
+};
+
+// The keys in the layout of Polyglot's Random64 table
+// (http://hgm.nubati.net/book_format.html): 64 squares for each of 12 pieces,
+// then the four castling rights, the eight en passant files and the side to
+// move.
+inline constexpr int kNumPolyglotKeys = 781;
+inline constexpr int kPolyglotCastlingOffset = 768;
+inline constexpr int kPolyglotEnPassantOffset = 772;
+inline constexpr int kPolyglotTurnOffset = 780;
+
+// Returns the index of the key of `side`'s `piece` on `square`. Polyglot
+// orders the pieces black pawn, white pawn, black knight, ..., white king, and
+// numbers the rows from rank 1.
+constexpr int GetPolyglotPieceIndex(const Square square, const Piece piece,
+                                    const Side side) {
+  const int kind = 2 * piece + (side == kWhite ? 1 : 0);
+  const int row = 7 - GetRank(square);
+  return 64 * kind + 8 * row + GetFile(square);
+}
 
+// The values are drawn from the fixed seed rather than copied from Polyglot's
+// published table, so keys are reproducible but do not match Polyglot books
+// yet. Pasting the published values here is all that is needed to match them,
+// since Position follows Polyglot in only hashing capturable en passant
+// targets.
+consteval std::array<std::uint64_t, kNumPolyglotKeys> MakeRandom64() {
+  ZobristRandom random(1070372);
+  std::array<std::uint64_t, kNumPolyglotKeys> random64{};
+  for (std::uint64_t& key : random64) {
+    key = random.Next();
+  }
+  return random64;
+}
+
+inline constexpr std::array<std::uint64_t, kNumPolyglotKeys> kRandom64 =
+    MakeRandom64();
+
+struct ZobristKeys {
   std::array<std::array<std::array<std::uint64_t, kNumSides>, kNumPieces>,
              kNumSquares>
       elements;
   std::array<std::uint64_t, kFiles> en_passant_files;
+
+  // Indexed by CastlingRights::Get(). Each entry is the XOR of the keys of
+  // its rights, as in Polyglot.
   std::array<std::uint64_t, kNumCastlingCombinations> castling;
 
-  std::uint64_t black_to_move;
+  // Polyglot hashes the side to move when it is white.
+  std::uint64_t white_to_move;
 };
 
-inline ZobristKeys::ZobristKeys() : elements(), en_passant_files(), castling() {
-  static_assert(std::tuple_size_v<decltype(elements)> == kNumSquares);
-  static_assert(std::tuple_size_v<decltype(elements)::value_type> ==
-                kNumPieces);
-
-  std::mt19937 engine(std::random_device{}());
-  std::uniform_int_distribution<std::uint64_t> dist(0);
+consteval ZobristKeys MakeZobristKeys() {
+  ZobristKeys keys{};
 
-  for (int i = 0; i < kNumSquares; ++i) {
-    for (int j = 0; j < kNumPieces; ++j) {
-      for (int k = 0; k < kNumSides; ++k) {
-        DCHECK_EQ(elements[i][j].size(), kNumSides);
-        elements[i][j][k] = dist(engine);
+  for (std::size_t square = 0; square < kNumSquares; ++square) {
+    for (int piece = kPawn; piece <= kKing; ++piece) {
+      for (int side = kWhite; side <= kBlack; ++side) {
+        keys.elements[square][piece][side] =
+            kRandom64[GetPolyglotPieceIndex(static_cast<Square>(square),
+                                            static_cast<Piece>(piece),
+                                            static_cast<Side>(side))];
       }
     }
   }
 
-  for (std::uint64_t& file : en_passant_files) {
-    file = dist(engine);
+  for (std::size_t file = 0; file < kFiles; ++file) {
+    keys.en_passant_files[file] = kRandom64[kPolyglotEnPassantOffset + file];
   }
 
-  for (std::uint64_t& combination : castling) {
-    combination = dist(engine);
+  // The rights are the bits of CastlingRights::Get() in Polyglot's order:
+  // white king side, white queen side, black king side, black queen side.
+  for (std::size_t combination = 0; combination < kNumCastlingCombinations;
+       ++combination) {
+    for (int right = 0; right < 4; ++right) {
+      if (combination & (1 << right)) {
+        keys.castling[combination] ^=
+            kRandom64[kPolyglotCastlingOffset + right];
+      }
+    }
   }
 
-  black_to_move = dist(engine);
+  keys.white_to_move = kRandom64[kPolyglotTurnOffset];
+  return keys;
 }
 
-// N.B.: ZobristKeys relies on a random number generator, so it cannot be
-// defined as a constexpr variable.
-inline const ZobristKeys kZobristKeys;
+inline constexpr ZobristKeys kZobristKeys = MakeZobristKeys();
 
 class [[nodiscard]] ZobristKey {
  public:
@@ -81,8 +142,10 @@ class [[nodiscard]] ZobristKey {
     key_ ^= kZobristKeys.elements[square][piece][side];
   }
 
-  void UpdateSideToMove() { key_ ^= kZobristKeys.black_to_move; }
+  void UpdateSideToMove() { key_ ^= kZobristKeys.white_to_move; }
 
+  // Polyglot only hashes the file of the target if a pawn can capture en
+  // passant. Callers pass nullopt for the other targets.
   void ToggleEnPassantTarget(const std::optional<Square> target) {
     if (target) {
       key_ ^= kZobristKeys.en_passant_files[GetFile(*target)];
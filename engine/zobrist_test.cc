@@ -20,13 +20,47 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <set>
+
 #include "engine/castling.h"
 
 namespace follychess {
 namespace {
 
+using ::testing::Contains;
 using ::testing::Eq;
 using ::testing::Not;
+using ::testing::SizeIs;
+
+TEST(ZobristKeys, AreUniqueAndNonZero) {
+  const std::set<std::uint64_t> keys(kRandom64.begin(), kRandom64.end());
+  EXPECT_THAT(keys, SizeIs(kNumPolyglotKeys));
+  EXPECT_THAT(keys, Not(Contains(0ULL)));
+}
+
+TEST(ZobristKeys, FollowPolyglotLayout) {
+  EXPECT_THAT(GetPolyglotPieceIndex(A1, kPawn, kBlack), Eq(0));
+  EXPECT_THAT(GetPolyglotPieceIndex(E2, kPawn, kWhite), Eq(76));
+  EXPECT_THAT(GetPolyglotPieceIndex(E8, kKing, kBlack), Eq(700));
+  EXPECT_THAT(GetPolyglotPieceIndex(H8, kKing, kWhite), Eq(767));
+
+  EXPECT_THAT(kZobristKeys.elements[E2][kPawn][kWhite], Eq(kRandom64[76]));
+  EXPECT_THAT(kZobristKeys.en_passant_files[0], Eq(kRandom64[772]));
+  EXPECT_THAT(kZobristKeys.en_passant_files[7], Eq(kRandom64[779]));
+  EXPECT_THAT(kZobristKeys.white_to_move, Eq(kRandom64[780]));
+}
+
+TEST(ZobristKeys, CastlingIsXorOfRights) {
+  EXPECT_THAT(kZobristKeys.castling[0], Eq(0ULL));
+  EXPECT_THAT(kZobristKeys.castling[kWhiteKing], Eq(kRandom64[768]));
+  EXPECT_THAT(kZobristKeys.castling[kWhiteQueen], Eq(kRandom64[769]));
+  EXPECT_THAT(kZobristKeys.castling[kBlackKing], Eq(kRandom64[770]));
+  EXPECT_THAT(kZobristKeys.castling[kBlackQueen], Eq(kRandom64[771]));
+  EXPECT_THAT(kZobristKeys.castling[kAllCastlingRights],
+              Eq(kRandom64[768] ^ kRandom64[769] ^ kRandom64[770] ^
+                 kRandom64[771]));
+}
 
 TEST(ZobristKey, Empty) {
   EXPECT_THAT(ZobristKey().GetValue(), Eq(0ULL));
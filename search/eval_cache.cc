@@ -0,0 +1,63 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/eval_cache.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <optional>
+
+#include "engine/zobrist.h"
+
+namespace follychess {
+
+EvalCache::EvalCache(const std::size_t size_mb) { Resize(size_mb); }
+
+void EvalCache::Resize(const std::size_t size_mb) {
+  constexpr std::size_t kBytesPerMb = 1024 * 1024;
+  const std::size_t size = size_mb * kBytesPerMb / sizeof(Entry);
+
+  size_mb_ = size_mb;
+  entries_.assign(size == 0 ? 0 : std::bit_floor(size), Entry());
+  ResetMetrics();
+}
+
+void EvalCache::Clear() { std::ranges::fill(entries_, Entry()); }
+
+std::optional<int> EvalCache::Probe(const ZobristKey key) {
+  if (entries_.empty()) {
+    return std::nullopt;
+  }
+
+  const Entry& entry = GetEntry(key);
+  if (entry.key != key) {
+    hit_counter_.RecordMiss();
+    return std::nullopt;
+  }
+
+  hit_counter_.RecordHit();
+  return entry.score;
+}
+
+void EvalCache::Record(const ZobristKey key, const int score) {
+  if (!entries_.empty()) {
+    GetEntry(key) = {.key = key, .score = score};
+  }
+}
+
+}  // namespace follychess
@@ -0,0 +1,88 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_EVAL_CACHE_H_
+#define FOLLYCHESS_SEARCH_EVAL_CACHE_H_
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "engine/zobrist.h"
+#include "search/hit_counter.h"
+
+namespace follychess {
+
+// A lossy cache of static evaluations keyed by the position's Zobrist key.
+// Quiescence search evaluates every node it visits, including positions that
+// were already reached through a different move order. Each slot holds a
+// single entry, and a new entry always replaces the old one. Each search
+// thread owns its own cache.
+class EvalCache {
+ public:
+  using Metrics = HitCounter::Metrics;
+
+  // Allocates the cache to fit within the specified memory limit. The number
+  // of entries is rounded down to the nearest power of two. A size of zero
+  // disables the cache.
+  explicit EvalCache(std::size_t size_mb = 1);
+
+  EvalCache(const EvalCache&) = delete;
+  EvalCache& operator=(const EvalCache&) = delete;
+
+  // Reallocates the cache to fit within the specified memory limit. All
+  // entries are lost.
+  void Resize(std::size_t size_mb);
+
+  // Removes all entries, e.g., when the evaluation function changes.
+  void Clear();
+
+  // Returns the evaluation recorded for `key`, if any.
+  [[nodiscard]] std::optional<int> Probe(ZobristKey key);
+
+  void Record(ZobristKey key, int score);
+
+  [[nodiscard]] Metrics GetMetrics() const { return hit_counter_.GetMetrics(); }
+
+  // Resets the metrics, but keeps the entries, since they stay valid across
+  // searches.
+  void ResetMetrics() { hit_counter_.Reset(); }
+
+  [[nodiscard]] std::size_t size_mb() const { return size_mb_; }
+
+  [[nodiscard]] std::size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    // Empty slots have a zero key, which no reachable position has in
+    // practice.
+    ZobristKey key;
+    int score = 0;
+  };
+
+  [[nodiscard]] Entry& GetEntry(const ZobristKey key) {
+    return entries_[key.GetValue() & (entries_.size() - 1)];
+  }
+
+  std::size_t size_mb_ = 0;
+  std::vector<Entry> entries_;
+  HitCounter hit_counter_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_EVAL_CACHE_H_
@@ -0,0 +1,97 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/eval_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "engine/zobrist.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::DoubleEq;
+using ::testing::Eq;
+using ::testing::Optional;
+
+TEST(EvalCache, Size) {
+  EXPECT_THAT(EvalCache(0).size(), Eq(0));
+  EXPECT_THAT(EvalCache(1).size(), Eq(1 << 16));
+  EXPECT_THAT(EvalCache(3).size(), Eq(1 << 17));
+  EXPECT_THAT(EvalCache(4).size(), Eq(1 << 18));
+}
+
+TEST(EvalCache, ProbeAndRecord) {
+  EvalCache cache(1);
+  EXPECT_THAT(cache.Probe(ZobristKey(123)), Eq(std::nullopt));
+
+  cache.Record(ZobristKey(123), -50);
+  EXPECT_THAT(cache.Probe(ZobristKey(123)), Optional(-50));
+
+  cache.Record(ZobristKey(456), 75);
+  EXPECT_THAT(cache.Probe(ZobristKey(456)), Optional(75));
+  EXPECT_THAT(cache.Probe(ZobristKey(123)), Optional(-50));
+}
+
+TEST(EvalCache, CollisionsReplaceOldEntries) {
+  EvalCache cache(1);
+  const ZobristKey key(1);
+  const ZobristKey colliding_key(1 + cache.size());
+
+  cache.Record(key, 10);
+  cache.Record(colliding_key, 20);
+  EXPECT_THAT(cache.Probe(key), Eq(std::nullopt));
+  EXPECT_THAT(cache.Probe(colliding_key), Optional(20));
+}
+
+TEST(EvalCache, Metrics) {
+  EvalCache cache(1);
+  cache.Record(ZobristKey(123), 0);
+  (void)cache.Probe(ZobristKey(123));
+  (void)cache.Probe(ZobristKey(123));
+  (void)cache.Probe(ZobristKey(456));
+
+  EXPECT_THAT(cache.GetMetrics().hits, Eq(2));
+  EXPECT_THAT(cache.GetMetrics().misses, Eq(1));
+  EXPECT_THAT(cache.GetMetrics().hit_rate, DoubleEq(2.0 / 3));
+
+  cache.ResetMetrics();
+  EXPECT_THAT(cache.GetMetrics().hits, Eq(0));
+  EXPECT_THAT(cache.GetMetrics().misses, Eq(0));
+  EXPECT_THAT(cache.Probe(ZobristKey(123)), Optional(0));
+}
+
+TEST(EvalCache, Disabled) {
+  EvalCache cache(0);
+  cache.Record(ZobristKey(123), 10);
+  EXPECT_THAT(cache.Probe(ZobristKey(123)), Eq(std::nullopt));
+  EXPECT_THAT(cache.GetMetrics().misses, Eq(0));
+}
+
+TEST(EvalCache, Resize) {
+  EvalCache cache(1);
+  cache.Record(ZobristKey(123), 10);
+
+  cache.Resize(2);
+  EXPECT_THAT(cache.size_mb(), Eq(2));
+  EXPECT_THAT(cache.size(), Eq(1 << 17));
+  EXPECT_THAT(cache.Probe(ZobristKey(123)), Eq(std::nullopt));
+}
+
+}  // namespace
+}  // namespace follychess
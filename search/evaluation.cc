@@ -17,7 +17,19 @@
 
 #include "search/evaluation.h"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
 #include "engine/attacks.h"
+#include "engine/cpu.h"
+#include "engine/isa_dispatch.h"
 #include "engine/move_generator.h"
 #include "engine/position.h"
 #include "search/phase.h"
@@ -134,6 +146,15 @@ consteval auto MakePlacementScores() {
 
 constexpr auto kPlacementScores = MakePlacementScores();
 
+constexpr std::array<int, kNumPieces> kMaterialScores = {
+    100,     // Pawn
+    300,     // Knight
+    300,     // Bishop
+    500,     // Rook
+    900,     // Queen
+    20'000,  // King
+};
+
 template <Side Side, Piece Piece>
 [[nodiscard]] constexpr Score GetPlacementScore(const Position& position) {
   Bitboard pieces = position.GetPieces(Side, Piece);
@@ -168,12 +189,14 @@ template Score GetPlacementScore<kBlack>(const Position& position);
 
 template <Side Side>
 int GetMaterialScore(const Position& position) {
-  return 20'000 * position.GetPieces(Side, kKing).GetCount() +
-         900 * position.GetPieces(Side, kQueen).GetCount() +
-         500 * position.GetPieces(Side, kRook).GetCount() +
-         300 * position.GetPieces(Side, kBishop).GetCount() +
-         300 * position.GetPieces(Side, kKnight).GetCount() +
-         100 * position.GetPieces(Side, kPawn).GetCount();
+  return kMaterialScores[kKing] * position.GetPieces(Side, kKing).GetCount() +
+         kMaterialScores[kQueen] * position.GetPieces(Side, kQueen).GetCount() +
+         kMaterialScores[kRook] * position.GetPieces(Side, kRook).GetCount() +
+         kMaterialScores[kBishop] *
+             position.GetPieces(Side, kBishop).GetCount() +
+         kMaterialScores[kKnight] *
+             position.GetPieces(Side, kKnight).GetCount() +
+         kMaterialScores[kPawn] * position.GetPieces(Side, kPawn).GetCount();
 }
 
 template int GetMaterialScore<kWhite>(const Position& position);
@@ -240,7 +263,7 @@ template Score GetPassedPawnScore<kBlack>(const Position& position);
 
 namespace {
 
-template <Side Side, Piece Piece>
+template <Side Side, Piece Piece, typename SliderAttacks>
 int CountMoves(const Position& position) {
   int mobility = 0;
 
@@ -249,19 +272,32 @@ int CountMoves(const Position& position) {
   while (pieces) {
     const Square square = pieces.PopLeastSignificantBit();
     const Bitboard attacks =
-        GenerateAttacks<Piece>(square, blockers) & ~position.GetPieces(Side);
+        GenerateAttacks<Piece, SliderAttacks>(square, blockers) &
+        ~position.GetPieces(Side);
     mobility += attacks.GetCount();
   }
 
   return mobility;
 }
 
+// Backs GetBishopMobilityScore() and GetQueenMobilityScore() with the slider
+// attacks of the running variant of Evaluate().
+template <Side Side, Piece Piece, typename SliderAttacks>
+Score GetMobilityScore(const Position& position) {
+  static_assert(Piece == kBishop || Piece == kQueen);
+  const int mobility = CountMoves<Side, Piece, SliderAttacks>(position);
+  if constexpr (Piece == kBishop) {
+    return {.middle = mobility * 5, .end = mobility * 5};
+  } else {
+    return {.middle = mobility * 1, .end = mobility * 2};
+  }
+}
+
 }  // namespace
 
 template <Side Side>
 Score GetBishopMobilityScore(const Position& position) {
-  const int mobility = CountMoves<Side, kBishop>(position) * 5;
-  return {.middle = mobility, .end = mobility};
+  return GetMobilityScore<Side, kBishop, DefaultSliderAttacks>(position);
 }
 
 template Score GetBishopMobilityScore<kWhite>(const Position& position);
@@ -269,8 +305,7 @@ template Score GetBishopMobilityScore<kBlack>(const Position& position);
 
 template <Side Side>
 Score GetQueenMobilityScore(const Position& position) {
-  const int mobility = CountMoves<Side, kQueen>(position);
-  return {.middle = mobility * 1, .end = mobility * 2};
+  return GetMobilityScore<Side, kQueen, DefaultSliderAttacks>(position);
 }
 
 template Score GetQueenMobilityScore<kWhite>(const Position& position);
@@ -378,26 +413,269 @@ namespace {
 }
 
 template <Side Side>
-[[nodiscard]] int Evaluate(const Position& position, int phase) {
-  const Score tapered_score =                   //
-      GetPlacementScore<Side>(position) +       //
-      GetKingSafetyScore<Side>(position) +      //
-      GetPassedPawnScore<Side>(position) +      //
-      GetBishopMobilityScore<Side>(position) +  //
-      GetQueenMobilityScore<Side>(position);
-
-  return Interpolate(tapered_score, phase) +            //
-         GetMaterialScore<Side>(position) +             //
-         -50 * CountDoubledPawns<Side>(position) +      //
-         -50 * CountBlockedPawns<Side>(position) +      //
-         10 * CountSemiOpenFileRooks<Side>(position) +  //
-         15 * CountOpenFileRooks<Side>(position);
+void FillPawnEntry(const Position& position, PawnHashTable::Entry& entry) {
+  entry.passed_pawn_scores[Side] = GetPassedPawnScore<Side>(position);
+  entry.doubled_pawns[Side] = CountDoubledPawns<Side>(position);
+
+  const Bitboard pawns = position.GetPieces(Side, kPawn);
+  entry.semi_open_files[Side] = Bitboard();
+  for (const Bitboard file : file::kFileMasks) {
+    if (!(file & pawns)) {
+      entry.semi_open_files[Side] |= file;
+    }
+  }
+}
+
+[[nodiscard]] PawnHashTable::Entry MakePawnEntry(const Position& position) {
+  PawnHashTable::Entry entry = {.key = position.GetPawnKey()};
+  FillPawnEntry<kWhite>(position, entry);
+  FillPawnEntry<kBlack>(position, entry);
+  return entry;
+}
+
+template <Side Side, typename SliderAttacks>
+[[nodiscard]] int Evaluate(const Position& position,
+                           const Score placement_score,
+                           const int material_score, const int phase,
+                           const PawnHashTable::Entry& pawns) {
+  const Score tapered_score =                                     //
+      placement_score +                                           //
+      GetKingSafetyScore<Side>(position) +                        //
+      pawns.passed_pawn_scores[Side] +                            //
+      GetMobilityScore<Side, kBishop, SliderAttacks>(position) +  //
+      GetMobilityScore<Side, kQueen, SliderAttacks>(position);
+
+  // Equivalent to CountSemiOpenFileRooks() and CountOpenFileRooks().
+  const Bitboard rooks = position.GetPieces(Side, kRook);
+  const Bitboard open_files =
+      pawns.semi_open_files[kWhite] & pawns.semi_open_files[kBlack];
+  const int semi_open_file_rooks =
+      (rooks & pawns.semi_open_files[Side]).GetCount();
+  const int open_file_rooks = (rooks & open_files).GetCount();
+
+  return Interpolate(tapered_score, phase) +        //
+         material_score +                           //
+         -50 * pawns.doubled_pawns[Side] +          //
+         -50 * CountBlockedPawns<Side>(position) +  //
+         10 * semi_open_file_rooks +                //
+         15 * open_file_rooks;
+}
+
+template <Side Side, typename SliderAttacks>
+[[nodiscard]] int Evaluate(const Position& position, int phase,
+                           const PawnHashTable::Entry& pawns) {
+  return Evaluate<Side, SliderAttacks>(
+      position, GetPlacementScore<Side>(position),
+      GetMaterialScore<Side>(position), phase, pawns);
+}
+
+template <Side Side, typename SliderAttacks>
+[[nodiscard]] int Evaluate(const Position& position,
+                           const EvaluationAccumulator& accumulator,
+                           const PawnHashTable::Entry& pawns) {
+  return Evaluate<Side, SliderAttacks>(
+      position, accumulator.GetPlacementScore(Side),
+      accumulator.GetMaterialScore(Side), accumulator.GetPhase(), pawns);
 }
 
 }  // namespace
 
-int Evaluate(const Position& position, int phase) {
-  return Evaluate<kWhite>(position, phase) - Evaluate<kBlack>(position, phase);
+int Evaluate(const Position& position, int phase, const Isa isa) {
+  return DispatchIsa(isa, [&]<typename SliderAttacks>() {
+    const PawnHashTable::Entry pawns = MakePawnEntry(position);
+    return Evaluate<kWhite, SliderAttacks>(position, phase, pawns) -
+           Evaluate<kBlack, SliderAttacks>(position, phase, pawns);
+  });
+}
+
+EvaluationAccumulator::EvaluationAccumulator(const Position& position) {
+  for (int i = 0; i < kNumSquares; ++i) {
+    const auto square = static_cast<Square>(i);
+    const Piece piece = position.GetPiece(square);
+    if (piece != kEmptyPiece) {
+      Add(position.GetSide(square), piece, square);
+    }
+  }
+}
+
+EvaluationAccumulator EvaluationAccumulator::After(const Position& position,
+                                                   const Move move) const {
+  EvaluationAccumulator result = *this;
+  if (move.IsNullMove()) {
+    return result;
+  }
+
+  const Side side = position.SideToMove();
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Piece piece = position.GetPiece(from);
+
+  if (const Piece captured = position.GetPiece(to); captured != kEmptyPiece) {
+    result.Remove(~side, captured, to);
+  }
+  if (move.IsEnPassantCapture()) {
+    result.Remove(~side, kPawn, move.GetEnPassantVictim());
+  }
+
+  result.Remove(side, piece, from);
+  result.Add(side, move.IsPromotion() ? move.GetPromotedPiece() : piece, to);
+
+  if (move.IsCastling()) {
+    static constexpr Square kKingSideRooks[kNumSides][2] = {{H1, F1},
+                                                            {H8, F8}};
+    static constexpr Square kQueenSideRooks[kNumSides][2] = {{A1, D1},
+                                                             {A8, D8}};
+    const auto& [rook_from, rook_to] = move.IsKingSideCastling()
+                                           ? kKingSideRooks[side]
+                                           : kQueenSideRooks[side];
+    result.Remove(side, kRook, rook_from);
+    result.Add(side, kRook, rook_to);
+  }
+
+  return result;
+}
+
+int EvaluationAccumulator::GetPhase() const {
+  return CalculatePhase(phase_material_);
+}
+
+void EvaluationAccumulator::Add(const Side side, const Piece piece,
+                                const Square square) {
+  const Square relative_square = side == kWhite ? square : Reflect(square);
+  placement_scores_[side] =
+      placement_scores_[side] + kPlacementScores[piece][relative_square];
+  material_scores_[side] += kMaterialScores[piece];
+  phase_material_ += kPhaseMaterialScores[piece];
+}
+
+void EvaluationAccumulator::Remove(const Side side, const Piece piece,
+                                   const Square square) {
+  const Square relative_square = side == kWhite ? square : Reflect(square);
+  placement_scores_[side] =
+      placement_scores_[side] - kPlacementScores[piece][relative_square];
+  material_scores_[side] -= kMaterialScores[piece];
+  phase_material_ -= kPhaseMaterialScores[piece];
+}
+
+PawnHashTable::PawnHashTable(const std::size_t size) : entries_(size) {
+  DCHECK(std::has_single_bit(size));
+}
+
+const PawnHashTable::Entry& PawnHashTable::Get(const Position& position) {
+  const ZobristKey key = position.GetPawnKey();
+  std::optional<Entry>& entry =
+      entries_[key.GetValue() & (entries_.size() - 1)];
+
+  if (entry && entry->key == key) {
+    hit_counter_.RecordHit();
+  } else {
+    hit_counter_.RecordMiss();
+    entry = MakePawnEntry(position);
+  }
+  return *entry;
+}
+
+int Evaluate(const Position& position, const EvaluationAccumulator& accumulator,
+             PawnHashTable& pawn_hash_table, const Isa isa) {
+  DCHECK(accumulator == EvaluationAccumulator(position));
+  return DispatchIsa(isa, [&]<typename SliderAttacks>() {
+    const PawnHashTable::Entry& pawns = pawn_hash_table.Get(position);
+    return Evaluate<kWhite, SliderAttacks>(position, accumulator, pawns) -
+           Evaluate<kBlack, SliderAttacks>(position, accumulator, pawns);
+  });
+}
+
+namespace {
+
+constexpr std::size_t kBatchChunkSize = 256;
+
+// Evaluates up to kBatchChunkSize positions.
+template <typename SliderAttacks>
+void EvaluateChunk(const std::span<const Position> positions,
+                   const std::span<int> scores,
+                   PawnHashTable& pawn_hash_table) {
+  DCHECK_LE(positions.size(), kBatchChunkSize);
+  const std::size_t size = positions.size();
+
+  // The loops over the positions below have no dependencies between
+  // iterations, so the compiler can vectorize them.
+  std::array<std::array<std::array<std::uint64_t, kBatchChunkSize>, kNumPieces>,
+             kNumSides>
+      pieces;
+  for (std::size_t i = 0; i < size; ++i) {
+    for (int side = kWhite; side <= kBlack; ++side) {
+      for (int piece = kPawn; piece <= kKing; ++piece) {
+        pieces[side][piece][i] =
+            positions[i]
+                .GetPieces(static_cast<Side>(side), static_cast<Piece>(piece))
+                .Data();
+      }
+    }
+  }
+
+  std::array<std::array<int, kBatchChunkSize>, kNumSides> material_scores{};
+  std::array<int, kBatchChunkSize> phase_material{};
+  for (int side = kWhite; side <= kBlack; ++side) {
+    for (int piece = kPawn; piece <= kKing; ++piece) {
+      for (std::size_t i = 0; i < size; ++i) {
+        const int count = std::popcount(pieces[side][piece][i]);
+        material_scores[side][i] += count * kMaterialScores[piece];
+        phase_material[i] += count * kPhaseMaterialScores[piece];
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    const Position& position = positions[i];
+    const PawnHashTable::Entry& pawns = pawn_hash_table.Get(position);
+    const int phase = CalculatePhase(phase_material[i]);
+    scores[i] =
+        Evaluate<kWhite, SliderAttacks>(position,
+                                        GetPlacementScore<kWhite>(position),
+                                        material_scores[kWhite][i], phase,
+                                        pawns) -
+        Evaluate<kBlack, SliderAttacks>(position,
+                                        GetPlacementScore<kBlack>(position),
+                                        material_scores[kBlack][i], phase,
+                                        pawns);
+  }
+}
+
+}  // namespace
+
+void EvaluateBatch(const std::span<const Position> positions,
+                   const std::span<int> scores, const int threads) {
+  DCHECK_EQ(positions.size(), scores.size());
+  const std::size_t num_chunks =
+      (positions.size() + kBatchChunkSize - 1) / kBatchChunkSize;
+
+  // Each thread takes the next chunk until none are left, so that threads
+  // that finish early are not left idle.
+  std::atomic<std::size_t> next_chunk = 0;
+  const Isa isa = GetBestIsa();
+  const auto run = [&] {
+    PawnHashTable pawn_hash_table;
+    for (std::size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+         chunk < num_chunks;
+         chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+      const std::size_t begin = chunk * kBatchChunkSize;
+      const std::size_t size =
+          std::min(kBatchChunkSize, positions.size() - begin);
+      DispatchIsa(isa, [&]<typename SliderAttacks>() {
+        EvaluateChunk<SliderAttacks>(positions.subspan(begin, size),
+                                     scores.subspan(begin, size),
+                                     pawn_hash_table);
+      });
+    }
+  };
+
+  const std::size_t num_threads =
+      std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(num_chunks, 1));
+  std::vector<std::jthread> workers;
+  for (std::size_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back(run);
+  }
+  run();
 }
 
 }  // namespace follychess
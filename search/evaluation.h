@@ -18,7 +18,20 @@
 #ifndef FOLLYCHESS_SEARCH_EVALUATION_H_
 #define FOLLYCHESS_SEARCH_EVALUATION_H_
 
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "engine/bitboard.h"
+#include "engine/cpu.h"
+#include "engine/move.h"
 #include "engine/position.h"
+#include "engine/types.h"
+#include "engine/zobrist.h"
+#include "search/hit_counter.h"
 
 namespace follychess {
 
@@ -33,6 +46,12 @@ struct Score {
   constexpr Score operator+(const Score other) const {
     return {.middle = middle + other.middle, .end = end + other.end};
   }
+
+  constexpr Score operator-(const Score other) const {
+    return {.middle = middle - other.middle, .end = end - other.end};
+  }
+
+  constexpr bool operator==(const Score& other) const = default;
 };
 
 template <Side Side>
@@ -101,7 +120,103 @@ template <Side Side>
 template <Side Side>
 [[nodiscard]] Score GetKingSafetyScore(const Position& position);
 
-[[nodiscard]] int Evaluate(const Position& position, int phase);
+// `isa` selects the variant of the code to run, which the CPU must support.
+// All variants return the same score.
+[[nodiscard]] int Evaluate(const Position& position, int phase,
+                           Isa isa = GetBestIsa());
+
+// Keeps the evaluation terms that only depend on which piece is on which
+// square: the placement scores, the material and the game phase. A move only
+// changes a few squares, so the search updates these move by move instead of
+// recomputing them at every leaf.
+class EvaluationAccumulator {
+ public:
+  explicit EvaluationAccumulator(const Position& position);
+
+  // Returns the accumulator for the position after `move` is made in
+  // `position`, which must be the position this accumulator describes.
+  [[nodiscard]] EvaluationAccumulator After(const Position& position,
+                                            Move move) const;
+
+  [[nodiscard]] Score GetPlacementScore(const Side side) const {
+    return placement_scores_[side];
+  }
+
+  [[nodiscard]] int GetMaterialScore(const Side side) const {
+    return material_scores_[side];
+  }
+
+  [[nodiscard]] int GetPhase() const;
+
+  bool operator==(const EvaluationAccumulator& other) const = default;
+
+ private:
+  void Add(Side side, Piece piece, Square square);
+
+  void Remove(Side side, Piece piece, Square square);
+
+  std::array<Score, kNumSides> placement_scores_ = {};
+  std::array<int, kNumSides> material_scores_ = {};
+  int phase_material_ = 0;
+};
+
+// Caches the evaluation terms that only depend on the pawns, keyed by
+// Position::GetPawnKey(). The pawn structure rarely changes between nearby
+// nodes of the search, so most lookups hit. Each search thread owns its own
+// table.
+class PawnHashTable {
+ public:
+  struct Entry {
+    ZobristKey key;
+    std::array<Score, kNumSides> passed_pawn_scores;
+    std::array<int, kNumSides> doubled_pawns;
+
+    // The union of the files that contain no pawns of the given side.
+    std::array<Bitboard, kNumSides> semi_open_files;
+  };
+
+  using Metrics = HitCounter::Metrics;
+
+  // Creates a table with the given number of entries, which must be a power
+  // of two.
+  explicit PawnHashTable(std::size_t size = 8192);
+
+  PawnHashTable(const PawnHashTable&) = delete;
+  PawnHashTable& operator=(const PawnHashTable&) = delete;
+
+  // Returns the entry for the pawn structure of `position`, computing and
+  // storing it on a miss. The reference is valid until the next call.
+  [[nodiscard]] const Entry& Get(const Position& position);
+
+  [[nodiscard]] Metrics GetMetrics() const { return hit_counter_.GetMetrics(); }
+
+  // Resets the metrics, but keeps the entries, since they stay valid across
+  // searches.
+  void ResetMetrics() { hit_counter_.Reset(); }
+
+ private:
+  std::vector<std::optional<Entry>> entries_;
+  HitCounter hit_counter_;
+};
+
+// Like above, but takes the placement, material and phase terms from
+// `accumulator`, which must describe `position`, and the pawn structure terms
+// from `pawn_hash_table`.
+[[nodiscard]] int Evaluate(const Position& position,
+                           const EvaluationAccumulator& accumulator,
+                           PawnHashTable& pawn_hash_table,
+                           Isa isa = GetBestIsa());
+
+// Evaluates many positions at once, e.g., for offline tooling. Stores
+// Evaluate(positions[i], CalculatePhase(positions[i])) in `scores[i]`.
+// `scores` must be as large as `positions`.
+//
+// The positions are split into chunks, which are spread across `threads`
+// threads. Within a chunk, the material and phase are computed for all
+// positions together from a structure-of-arrays copy of the piece bitboards,
+// and the pawn structure terms are cached across positions.
+void EvaluateBatch(std::span<const Position> positions, std::span<int> scores,
+                   int threads = std::thread::hardware_concurrency());
 
 }  // namespace follychess
 
@@ -20,14 +20,24 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <array>
+#include <string_view>
+#include <vector>
+
+#include "engine/cpu.h"
+#include "engine/move_generator.h"
 #include "engine/position.h"
+#include "engine/scoped_move.h"
 #include "engine/testing.h"
 #include "search/phase.h"
 
 namespace follychess {
 namespace {
 
+using ::testing::DoubleEq;
 using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::Not;
 
 TEST(PassedPawnMasks, White) {
   EXPECT_THAT(kPassedPawnMasks[kWhite][E4],
@@ -1201,5 +1211,126 @@ TEST(Evaluate, CastledWhiteKing) {
               Eq(240));
 }
 
+TEST(EvaluationAccumulator, MatchesFullEvaluation) {
+  constexpr std::array<std::string_view, 3> kFens = {
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+      "r3k2r/1P4P1/8/8/8/8/1p4p1/R3K2R b KQkq - 0 1",
+  };
+
+  for (std::string_view fen : kFens) {
+    Position position = Position::FromFen(fen).value();
+    const EvaluationAccumulator accumulator(position);
+    EXPECT_THAT(accumulator.GetPhase(), Eq(CalculatePhase(position)));
+
+    PawnHashTable pawn_hash_table;
+    for (const Move move : GenerateLegalMoves(position)) {
+      const EvaluationAccumulator next = accumulator.After(position, move);
+      ScopedMove scoped_move(move, position);
+
+      EXPECT_THAT(next, Eq(EvaluationAccumulator(position)))
+          << fen << " " << move;
+      EXPECT_THAT(Evaluate(position, next, pawn_hash_table),
+                  Eq(Evaluate(position, CalculatePhase(position))))
+          << fen << " " << move;
+    }
+  }
+}
+
+TEST(Evaluate, SameScoreForEveryIsa) {
+  // One ply from Kiwipete, whose sliders have many moves.
+  Position position =
+      Position::FromFen(
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")
+          .value();
+  for (const Isa isa : {Isa::kPopcnt, Isa::kBmi2}) {
+    if (!IsSupported(isa)) {
+      continue;
+    }
+    for (const Move move : GenerateLegalMoves(position)) {
+      ScopedMove scoped_move(move, position);
+      const int phase = CalculatePhase(position);
+      EXPECT_THAT(Evaluate(position, phase, isa),
+                  Eq(Evaluate(position, phase, Isa::kGeneric)))
+          << ToString(isa) << " " << move;
+    }
+  }
+}
+
+TEST(EvaluateBatch, MatchesEvaluate) {
+  // Two plies from Kiwipete, which spans several chunks.
+  std::vector<Position> positions;
+  Position position =
+      Position::FromFen(
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")
+          .value();
+  for (const Move move : GenerateLegalMoves(position)) {
+    ScopedMove scoped_move(move, position);
+    for (const Move reply : GenerateLegalMoves(position)) {
+      ScopedMove scoped_reply(reply, position);
+      positions.push_back(position);
+    }
+  }
+
+  std::vector<int> expected;
+  for (const Position& curr : positions) {
+    expected.push_back(Evaluate(curr, CalculatePhase(curr)));
+  }
+
+  for (const int threads : {1, 4}) {
+    std::vector<int> scores(positions.size());
+    EvaluateBatch(positions, scores, threads);
+    EXPECT_THAT(scores, Eq(expected)) << threads;
+  }
+}
+
+TEST(EvaluateBatch, Empty) {
+  std::vector<int> scores;
+  EvaluateBatch({}, scores);
+  EXPECT_THAT(scores, IsEmpty());
+}
+
+TEST(PawnHashTable, HitsOnSamePawnStructure) {
+  PawnHashTable pawn_hash_table;
+  Position position = Position::Starting();
+
+  const PawnHashTable::Entry entry = pawn_hash_table.Get(position);
+  EXPECT_THAT(entry.key, Eq(position.GetPawnKey()));
+  EXPECT_THAT(entry.doubled_pawns[kWhite], Eq(0));
+  EXPECT_THAT(entry.semi_open_files[kWhite], Eq(Bitboard()));
+  EXPECT_THAT(pawn_hash_table.GetMetrics().misses, Eq(1));
+
+  {
+    // Knight moves keep the pawn structure.
+    ScopedMove scoped_move(Move(G1, F3), position);
+    EXPECT_THAT(pawn_hash_table.Get(position).key, Eq(entry.key));
+    EXPECT_THAT(pawn_hash_table.GetMetrics().hits, Eq(1));
+  }
+
+  {
+    ScopedMove scoped_move(Move(E2, E4, Move::Flags::kDoublePawnPush),
+                           position);
+    EXPECT_THAT(pawn_hash_table.Get(position).key, Not(Eq(entry.key)));
+    EXPECT_THAT(pawn_hash_table.GetMetrics().misses, Eq(2));
+  }
+
+  EXPECT_THAT(pawn_hash_table.GetMetrics().hit_rate, DoubleEq(1.0 / 3));
+  pawn_hash_table.ResetMetrics();
+  EXPECT_THAT(pawn_hash_table.GetMetrics().hits, Eq(0));
+  EXPECT_THAT(pawn_hash_table.GetMetrics().misses, Eq(0));
+}
+
+TEST(PawnHashTable, SemiOpenFiles) {
+  PawnHashTable pawn_hash_table;
+  const Position position =
+      Position::FromFen("4k3/pp3ppp/8/8/8/8/PPP2PP1/4K3 w - - 0 1").value();
+
+  const PawnHashTable::Entry& entry = pawn_hash_table.Get(position);
+  EXPECT_THAT(entry.semi_open_files[kWhite],
+              Eq(file::kD | file::kE | file::kH));
+  EXPECT_THAT(entry.semi_open_files[kBlack],
+              Eq(file::kC | file::kD | file::kE));
+}
+
 }  // namespace
 }  // namespace follychess
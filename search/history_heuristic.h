@@ -33,18 +33,35 @@ class HistoryHeuristic {
   HistoryHeuristic(HistoryHeuristic&&) = delete;
   HistoryHeuristic& operator=(HistoryHeuristic&&) = delete;
 
+  // Rewards a quiet move that caused a beta cutoff. `position` is the one the
+  // move is played from.
   void Set(const Position& position, const Move move, const int depth) {
-    if (!move.IsCapture()) {
+    if (move.IsCapture()) {
+      // Captures are ordered by MVV-LVA instead.
       return;
     }
 
-    // N.B.: By the time this function is called, the move has already been
-    // applies to the position, so we use the destination square to get the
-    // moved piece.
-    const Piece piece = position.GetPiece(move.GetTo());
+    const Piece piece = position.GetPiece(move.GetFrom());
     DCHECK_NE(piece, kEmptyPiece);
 
-    history_[position.SideToMove()][piece][move.GetTo()] += depth * depth;
+    int& score = history_[position.SideToMove()][piece][move.GetTo()];
+    score += depth * depth;
+    if (score > kMaxScore) {
+      // Keeps the scores below the killer moves in the move ordering.
+      Age();
+    }
+  }
+
+  // Halves all scores. This is called between searches, so that moves that
+  // were good earlier in the game still count, but less than fresh ones.
+  void Age() {
+    for (auto& pieces : history_) {
+      for (auto& squares : pieces) {
+        for (int& score : squares) {
+          score /= 2;
+        }
+      }
+    }
   }
 
   [[nodiscard]] int Get(const Position& position, const Move move) const {
@@ -54,6 +71,8 @@ class HistoryHeuristic {
   }
 
  private:
+  static constexpr int kMaxScore = 50'000;
+
   std::array<std::array<std::array<int, kNumSquares>, kNumPieces>, kNumSides>
       history_ = {};
 };
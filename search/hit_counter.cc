@@ -0,0 +1,52 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/hit_counter.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace follychess {
+namespace {
+
+HitCounter::Metrics MakeMetrics(const std::int64_t hits,
+                                const std::int64_t misses) {
+  double hit_rate = 0;
+  if (hits + misses != 0) {
+    hit_rate = static_cast<double>(hits) / static_cast<double>(hits + misses);
+  }
+  return {.hits = hits, .misses = misses, .hit_rate = hit_rate};
+}
+
+}  // namespace
+
+HitCounter::Metrics HitCounter::Metrics::operator+(
+    const Metrics& other) const {
+  return MakeMetrics(hits + other.hits, misses + other.misses);
+}
+
+HitCounter::Metrics HitCounter::GetMetrics() const {
+  return MakeMetrics(hits_.load(std::memory_order_relaxed),
+                     misses_.load(std::memory_order_relaxed));
+}
+
+void HitCounter::Reset() {
+  hits_.store(0, std::memory_order_relaxed);
+  misses_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace follychess
@@ -0,0 +1,61 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_HIT_COUNTER_H_
+#define FOLLYCHESS_SEARCH_HIT_COUNTER_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace follychess {
+
+// Counts the hits and misses of a table that is owned by a single search
+// thread. The counts are written only by the owning thread, but read by the
+// main thread when reporting search info, so they are atomic. Since there is
+// a single writer, a relaxed load and store replace the read-modify-write.
+class HitCounter {
+ public:
+  struct Metrics {
+    std::int64_t hits = 0;
+    std::int64_t misses = 0;
+    double hit_rate = 0;
+
+    // Adds up the counts of two tables, e.g., those of two search threads.
+    [[nodiscard]] Metrics operator+(const Metrics& other) const;
+  };
+
+  void RecordHit() { Increment(hits_); }
+
+  void RecordMiss() { Increment(misses_); }
+
+  [[nodiscard]] Metrics GetMetrics() const;
+
+  void Reset();
+
+ private:
+  static void Increment(std::atomic<std::int64_t>& count) {
+    count.store(count.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+  }
+
+  std::atomic<std::int64_t> hits_ = 0;
+  std::atomic<std::int64_t> misses_ = 0;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_HIT_COUNTER_H_
@@ -0,0 +1,60 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/hit_counter.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace follychess {
+namespace {
+
+using ::testing::DoubleEq;
+using ::testing::Eq;
+
+TEST(HitCounter, Metrics) {
+  HitCounter counter;
+  EXPECT_THAT(counter.GetMetrics().hit_rate, Eq(0));
+
+  counter.RecordHit();
+  counter.RecordHit();
+  counter.RecordMiss();
+  EXPECT_THAT(counter.GetMetrics().hits, Eq(2));
+  EXPECT_THAT(counter.GetMetrics().misses, Eq(1));
+  EXPECT_THAT(counter.GetMetrics().hit_rate, DoubleEq(2.0 / 3));
+
+  counter.Reset();
+  EXPECT_THAT(counter.GetMetrics().hits, Eq(0));
+  EXPECT_THAT(counter.GetMetrics().misses, Eq(0));
+}
+
+TEST(HitCounter, Sum) {
+  HitCounter first;
+  first.RecordHit();
+  HitCounter second;
+  second.RecordMiss();
+  second.RecordMiss();
+  second.RecordMiss();
+
+  const HitCounter::Metrics sum = first.GetMetrics() + second.GetMetrics();
+  EXPECT_THAT(sum.hits, Eq(1));
+  EXPECT_THAT(sum.misses, Eq(3));
+  EXPECT_THAT(sum.hit_rate, DoubleEq(0.25));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -103,50 +103,55 @@ std::string join(const std::vector<Move>& moves) {
   return result;
 }
 
+int ScoreMove(const Position& position, const Move priority_move,
+              const KillerMoves::Entry& killer_moves,
+              const HistoryHeuristic& history_heuristic, const Move move) {
+  if (priority_move == move) {
+    return kPriorityMoveScale;
+  }
+
+  if (move.IsCapture()) {
+    const Piece attacker = position.GetPiece(move.GetFrom());
+    const Piece victim =
+        move.IsEnPassantCapture() ? kPawn : position.GetPiece(move.GetTo());
+    DCHECK_NE(attacker, kEmptyPiece);
+    DCHECK_NE(victim, kEmptyPiece);
+
+    return kCaptureScale + kMvvLvaTable[victim][attacker];
+  }
+
+  if (move.IsPromotion()) {
+    DCHECK_GT(kQueen, kRook);
+    DCHECK_GT(kRook, kBishop);
+    DCHECK_GT(kBishop, kKnight);
+
+    return kPromotionScale + move.GetPromotedPiece();
+  }
+
+  if (move.IsCastling()) {
+    return kCastlingScale;
+  }
+
+  if (move == killer_moves.first) {
+    return kKillerMoveScale + 1;
+  }
+  if (move == killer_moves.second) {
+    return kKillerMoveScale;
+  }
+
+  const int history_score = history_heuristic.Get(position, move);
+  DCHECK_LT(history_score, kKillerMoveScale - kHistoryHeuristicScale);
+  return kHistoryHeuristicScale + history_score;
+}
+
 void OrderMoves(const Position& position, Move priority_move,
                 const KillerMoves::Entry& killer_moves,
                 const HistoryHeuristic& history_heuristic,
                 std::vector<Move>& moves) {
-  auto sort_key = [&](const Move move) {
-    if (priority_move == move) {
-      return kPriorityMoveScale;
-    }
-
-    if (move.IsCapture()) {
-      const Piece attacker = position.GetPiece(move.GetFrom());
-      const Piece victim =
-          move.IsEnPassantCapture() ? kPawn : position.GetPiece(move.GetTo());
-      DCHECK_NE(attacker, kEmptyPiece);
-      DCHECK_NE(victim, kEmptyPiece);
-
-      return kCaptureScale + kMvvLvaTable[victim][attacker];
-    }
-
-    if (move.IsPromotion()) {
-      DCHECK_GT(kQueen, kRook);
-      DCHECK_GT(kRook, kBishop);
-      DCHECK_GT(kBishop, kKnight);
-
-      return kPromotionScale + move.GetPromotedPiece();
-    }
-
-    if (move.IsCastling()) {
-      return kCastlingScale;
-    }
-
-    if (move == killer_moves.first) {
-      return kKillerMoveScale + 1;
-    }
-    if (move == killer_moves.second) {
-      return kKillerMoveScale;
-    }
-
-    const int history_score = history_heuristic.Get(position, move);
-    DCHECK_LT(history_score, kKillerMoveScale - kHistoryHeuristicScale);
-    return kHistoryHeuristicScale + history_score;
-  };
-
-  std::ranges::sort(moves, std::greater(), sort_key);
+  std::ranges::sort(moves, std::greater(), [&](const Move move) {
+    return ScoreMove(position, priority_move, killer_moves, history_heuristic,
+                     move);
+  });
 }
 
 }  // namespace follychess
@@ -27,6 +27,15 @@
 
 namespace follychess {
 
+// Returns how promising `move` is. The priority move scores highest, followed
+// by captures in MVV-LVA order, promotions, castling, killer moves, and
+// finally the remaining quiet moves by their history.
+[[nodiscard]] int ScoreMove(const Position& position, Move priority_move,
+                            const KillerMoves::Entry& killer_moves,
+                            const HistoryHeuristic& history_heuristic,
+                            Move move);
+
+// Sorts the moves by descending ScoreMove().
 void OrderMoves(const Position& position, Move priority_move,
                 const KillerMoves::Entry& killer_moves,
                 const HistoryHeuristic& history_heuristic,
@@ -0,0 +1,238 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/move_picker.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/move_list.h"
+#include "engine/position.h"
+#include "engine/types.h"
+#include "search/history_heuristic.h"
+#include "search/killer_moves.h"
+#include "search/move_ordering.h"
+#include "search/see.h"
+
+namespace follychess {
+namespace {
+
+// The quiescent search only orders captures, which ignore the history.
+const HistoryHeuristic& GetEmptyHistory() {
+  static const HistoryHeuristic history;
+  return history;
+}
+
+}  // namespace
+
+MovePicker::MovePicker(const Position& position, const Move transposition_move,
+                       const KillerMoves::Entry& killer_moves,
+                       const HistoryHeuristic& history_heuristic)
+    : position_(position),
+      transposition_move_(transposition_move),
+      killer_moves_(killer_moves),
+      history_heuristic_(history_heuristic),
+      captures_only_(false) {}
+
+MovePicker::MovePicker(const Position& position, const Move transposition_move,
+                       const bool skip_bad_captures)
+    : position_(position),
+      transposition_move_(transposition_move),
+      history_heuristic_(GetEmptyHistory()),
+      captures_only_(true),
+      skip_bad_captures_(skip_bad_captures) {}
+
+std::optional<Move> MovePicker::Next() {
+  while (true) {
+    switch (stage_) {
+      case Stage::kTranspositionMove:
+        stage_ = PicksEvasions() ? Stage::kEvasions : Stage::kGoodCaptures;
+        if (IsValidTranspositionMove()) {
+          return transposition_move_;
+        }
+        break;
+
+      case Stage::kGoodCaptures:
+        GenerateCaptures();
+        if (std::optional<Move> move = SelectBest(good_captures_)) {
+          return move;
+        }
+        if (!captures_only_) {
+          stage_ = Stage::kKillerMoves;
+        } else {
+          stage_ = skip_bad_captures_ ? Stage::kDone : Stage::kBadCaptures;
+        }
+        break;
+
+      case Stage::kKillerMoves:
+        // Killer moves are quiet moves from sibling nodes, so they are only
+        // played if they are among this position's quiet moves.
+        GenerateQuiets();
+        while (killer_index_ < 2) {
+          const Move killer = killer_index_++ == 0 ? killer_moves_.first
+                                                   : killer_moves_.second;
+          if (killer != Move::NullMove() && killer != transposition_move_ &&
+              Contains(quiets_, killer) && IsLegal(position_, killer)) {
+            return killer;
+          }
+        }
+        stage_ = Stage::kQuiets;
+        break;
+
+      case Stage::kQuiets:
+        if (std::optional<Move> move = SelectBest(quiets_)) {
+          return move;
+        }
+        stage_ = Stage::kBadCaptures;
+        break;
+
+      case Stage::kBadCaptures:
+        if (std::optional<Move> move = SelectBest(bad_captures_)) {
+          return move;
+        }
+        stage_ = Stage::kDone;
+        break;
+
+      case Stage::kEvasions:
+        GenerateEvasions();
+        if (std::optional<Move> move = SelectBest(evasions_)) {
+          return move;
+        }
+        stage_ = Stage::kDone;
+        break;
+
+      case Stage::kDone:
+        return std::nullopt;
+    }
+  }
+}
+
+bool MovePicker::IsValidTranspositionMove() {
+  if (transposition_move_ == Move::NullMove()) {
+    return false;
+  }
+
+  const StageMoves* stage = nullptr;
+  if (PicksEvasions()) {
+    GenerateEvasions();
+    stage = &evasions_;
+  } else if (transposition_move_.IsCapture()) {
+    GenerateCaptures();
+    const bool good = IsGoodCapture(position_, transposition_move_);
+    if (!good && skip_bad_captures_) {
+      return false;
+    }
+    stage = good ? &good_captures_ : &bad_captures_;
+  } else if (!captures_only_) {
+    GenerateQuiets();
+    stage = &quiets_;
+  } else {
+    return false;
+  }
+
+  return Contains(*stage, transposition_move_) &&
+         IsLegal(position_, transposition_move_);
+}
+
+bool MovePicker::PicksEvasions() const {
+  return !captures_only_ && position_.GetCheckers(position_.SideToMove());
+}
+
+bool MovePicker::IsKillerMove(const Move move) const {
+  return move == killer_moves_.first || move == killer_moves_.second;
+}
+
+bool MovePicker::Contains(const StageMoves& stage, const Move move) const {
+  return std::ranges::contains(moves_.begin() + stage.begin,
+                               moves_.begin() + stage.end, move);
+}
+
+std::optional<Move> MovePicker::SelectBest(StageMoves& stage) {
+  while (stage.next < stage.end) {
+    std::size_t best = stage.next;
+    for (std::size_t i = stage.next + 1; i < stage.end; ++i) {
+      if (scores_[i] > scores_[best]) {
+        best = i;
+      }
+    }
+    std::swap(moves_[stage.next], moves_[best]);
+    std::swap(scores_[stage.next], scores_[best]);
+    const Move move = moves_[stage.next++];
+
+    // These were handed out by their own stages.
+    if (move == transposition_move_ ||
+        (&stage == &quiets_ && IsKillerMove(move))) {
+      continue;
+    }
+    if (IsLegal(position_, move)) {
+      return move;
+    }
+  }
+  return std::nullopt;
+}
+
+void MovePicker::GenerateCaptures() {
+  if (good_captures_.generated) {
+    return;
+  }
+
+  const std::size_t begin = moves_.size();
+  GenerateMoves<kCapture>(position_, moves_);
+  const auto bad_captures =
+      std::partition(moves_.begin() + begin, moves_.end(), [&](Move move) {
+        return IsGoodCapture(position_, move);
+      });
+  const std::size_t middle = bad_captures - moves_.begin();
+  good_captures_ = MakeStage(begin, middle);
+  bad_captures_ = MakeStage(middle, moves_.size());
+}
+
+void MovePicker::GenerateQuiets() {
+  if (quiets_.generated) {
+    return;
+  }
+
+  const std::size_t begin = moves_.size();
+  GenerateMoves<kQuiet>(position_, moves_);
+  quiets_ = MakeStage(begin, moves_.size());
+}
+
+void MovePicker::GenerateEvasions() {
+  if (evasions_.generated) {
+    return;
+  }
+
+  const std::size_t begin = moves_.size();
+  GenerateMoves<kEvasion>(position_, moves_);
+  evasions_ = MakeStage(begin, moves_.size());
+}
+
+MovePicker::StageMoves MovePicker::MakeStage(const std::size_t begin,
+                                             const std::size_t end) {
+  for (std::size_t i = begin; i < end; ++i) {
+    scores_[i] = ScoreMove(position_, Move::NullMove(), killer_moves_,
+                           history_heuristic_, moves_[i]);
+  }
+  return {.begin = begin, .next = begin, .end = end, .generated = true};
+}
+
+}  // namespace follychess
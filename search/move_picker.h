@@ -0,0 +1,138 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_MOVE_PICKER_H_
+#define FOLLYCHESS_SEARCH_MOVE_PICKER_H_
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include "engine/move.h"
+#include "engine/move_list.h"
+#include "engine/position.h"
+#include "search/history_heuristic.h"
+#include "search/killer_moves.h"
+
+namespace follychess {
+
+// Hands out the legal moves of a position in the order they should be
+// searched. Most nodes cut off on one of the first moves, so the moves are
+// generated in stages, and each stage is only generated once it is reached:
+//
+//   1. The transposition table move.
+//   2. Good captures, i.e., ones that win material or trade evenly according
+//      to the static exchange evaluation, in MVV-LVA order.
+//   3. The killer moves.
+//   4. The remaining quiet moves, ordered by ScoreMove().
+//   5. Bad captures, in MVV-LVA order.
+//
+// In check, all evasions are generated at once after the transposition table
+// move. Rather than sorting a stage upfront, each call to Next() selects the
+// best remaining move of the current stage. Legality is also only checked for
+// the moves that are handed out.
+class MovePicker {
+ public:
+  // `position` must outlive the picker and be back in its original state
+  // whenever Next() is called.
+  //
+  // Picks all legal moves, for the main search.
+  MovePicker(const Position& position, Move transposition_move,
+             const KillerMoves::Entry& killer_moves,
+             const HistoryHeuristic& history_heuristic);
+
+  // Picks only the legal captures, for the quiescent search. With
+  // `skip_bad_captures`, the picker stops after the good captures, which
+  // spares the search from running the static exchange evaluation again.
+  MovePicker(const Position& position, Move transposition_move,
+             bool skip_bad_captures);
+
+  // Returns the next move to search, or nothing once all moves were picked.
+  [[nodiscard]] std::optional<Move> Next();
+
+ private:
+  enum class Stage {
+    kTranspositionMove,
+    kGoodCaptures,
+    kKillerMoves,
+    kQuiets,
+    kBadCaptures,
+    kEvasions,
+    kDone,
+  };
+
+  // The range of `moves_` that holds the moves of a stage. Moves before `next`
+  // were already handed out.
+  struct StageMoves {
+    std::size_t begin = 0;
+    std::size_t next = 0;
+    std::size_t end = 0;
+    bool generated = false;
+  };
+
+  // Returns whether the transposition table move can be played here. Since
+  // the table may return a move from a colliding position, the move is looked
+  // up in the stage it belongs to, which is generated early.
+  [[nodiscard]] bool IsValidTranspositionMove();
+
+  // Returns whether all moves are generated at once since the side to move is
+  // in check. The quiescent search only picks captures regardless.
+  [[nodiscard]] bool PicksEvasions() const;
+
+  [[nodiscard]] bool IsKillerMove(Move move) const;
+
+  [[nodiscard]] bool Contains(const StageMoves& stage, Move move) const;
+
+  // Returns the best remaining move of `stage` that is legal and was not handed
+  // out by an earlier stage.
+  [[nodiscard]] std::optional<Move> SelectBest(StageMoves& stage);
+
+  void GenerateCaptures();
+  void GenerateQuiets();
+  void GenerateEvasions();
+
+  // Scores the moves of `moves_` from `begin` to `end` and returns them as a
+  // stage.
+  [[nodiscard]] StageMoves MakeStage(std::size_t begin, std::size_t end);
+
+  // Not a copy, even though the game's position is changed in place by the
+  // moves searched while the picker is in use: the search only calls Next()
+  // after ScopedSearchMove has undone the previous move, and Game::position_
+  // keeps its address in both game modes.
+  const Position& position_;
+  const Move transposition_move_;
+  const KillerMoves::Entry killer_moves_;
+  const HistoryHeuristic& history_heuristic_;
+  const bool captures_only_;
+  const bool skip_bad_captures_ = false;
+
+  Stage stage_ = Stage::kTranspositionMove;
+  int killer_index_ = 0;
+
+  // The moves of all stages generated so far, along with their scores.
+  MoveList moves_;
+  std::array<int, MoveList::kCapacity> scores_;
+
+  StageMoves good_captures_;
+  StageMoves bad_captures_;
+  StageMoves quiets_;
+  StageMoves evasions_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_MOVE_PICKER_H_
@@ -0,0 +1,167 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/move_picker.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+#include "engine/testing.h"
+#include "search/history_heuristic.h"
+#include "search/killer_moves.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::Contains;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::Not;
+using ::testing::UnorderedElementsAreArray;
+
+std::vector<Move> PickAll(MovePicker& move_picker) {
+  std::vector<Move> moves;
+  while (std::optional<Move> move = move_picker.Next()) {
+    moves.push_back(*move);
+  }
+  return moves;
+}
+
+// PxP wins a pawn, while QxN and QxP lose the queen to the rook and the pawn.
+Position MakeCapturesPosition() {
+  return MakePosition(
+      "8: k . . . . r . ."
+      "7: . . . . . n . ."
+      "6: . . p . . . . ."
+      "5: . . . p . . . Q"
+      "4: . . . . P . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: K . . . . . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+}
+
+TEST(MovePicker, Stages) {
+  const Position position = MakeCapturesPosition();
+  HistoryHeuristic history_heuristic;
+  MovePicker move_picker(position, MakeMove("a1b1"),
+                         {.first = MakeMove("h5g5"), .second = MakeMove("a1a2")},
+                         history_heuristic);
+
+  std::vector<Move> moves = PickAll(move_picker);
+  EXPECT_THAT(moves, UnorderedElementsAreArray(GenerateLegalMoves(position)));
+
+  ASSERT_GE(moves.size(), 6);
+  EXPECT_THAT(std::vector(moves.begin(), moves.begin() + 4),
+              ElementsAreArray(MakeMoves({
+                  "a1b1",    // Transposition table move
+                  "e4d5#c",  // PxP
+                  "h5g5",    // Killer moves
+                  "a1a2",
+              })));
+  EXPECT_THAT(std::vector(moves.end() - 2, moves.end()),
+              ElementsAreArray(MakeMoves({
+                  "h5f7#c",  // QxN
+                  "h5d5#c",  // QxP
+              })));
+}
+
+TEST(MovePicker, CapturesOnly) {
+  const Position position = MakeCapturesPosition();
+  MovePicker move_picker(position, MakeMove("a1b1"),
+                         /*skip_bad_captures=*/false);
+
+  EXPECT_THAT(PickAll(move_picker), ElementsAreArray(MakeMoves({
+                                        "e4d5#c",
+                                        "h5f7#c",
+                                        "h5d5#c",
+                                    })));
+}
+
+TEST(MovePicker, SkipsBadCaptures) {
+  const Position position = MakeCapturesPosition();
+  MovePicker move_picker(position, MakeMove("h5f7#c"),
+                         /*skip_bad_captures=*/true);
+
+  EXPECT_THAT(PickAll(move_picker), ElementsAreArray(MakeMoves({"e4d5#c"})));
+}
+
+TEST(MovePicker, IgnoresInvalidMoves) {
+  const Position position = MakeCapturesPosition();
+  HistoryHeuristic history_heuristic;
+  MovePicker move_picker(position, MakeMove("e2e4"),
+                         {.first = MakeMove("h5h8")}, history_heuristic);
+
+  std::vector<Move> moves = PickAll(move_picker);
+  EXPECT_THAT(moves, UnorderedElementsAreArray(GenerateLegalMoves(position)));
+  EXPECT_THAT(moves, Not(Contains(MakeMove("e2e4"))));
+}
+
+TEST(MovePicker, Evasions) {
+  const Position position = MakePosition(
+      "8: . . . k . . . ."
+      "7: . . . . . N . ."
+      "6: . . . . . . b ."
+      "5: . . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . . . . K"
+      "   a b c d e f g h"
+      //
+      "   b - - 0 2");
+  HistoryHeuristic history_heuristic;
+  MovePicker move_picker(position, MakeMove("d8d7"), {}, history_heuristic);
+
+  std::vector<Move> moves = PickAll(move_picker);
+  EXPECT_THAT(moves, UnorderedElementsAreArray(GenerateLegalMoves(position)));
+  ASSERT_GE(moves.size(), 2);
+  EXPECT_THAT(moves[0], Eq(MakeMove("d8d7")));
+  EXPECT_THAT(moves[1], Eq(MakeMove("g6f7#c")));
+}
+
+TEST(MovePicker, SkipsIllegalMoves) {
+  const Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . r . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . B . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+  HistoryHeuristic history_heuristic;
+  MovePicker move_picker(position, MakeMove("e2d3"),
+                         {.first = MakeMove("e2f3")}, history_heuristic);
+
+  EXPECT_THAT(PickAll(move_picker),
+              UnorderedElementsAreArray(GenerateLegalMoves(position)));
+}
+
+}  // namespace
+}  // namespace follychess
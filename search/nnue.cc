@@ -0,0 +1,403 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/nnue.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "absl/log/check.h"
+#include "engine/bitboard.h"
+#include "engine/cpu.h"
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace follychess {
+namespace nnue {
+namespace {
+
+static_assert(std::endian::native == std::endian::little,
+              "Network files are read without byte swapping.");
+
+constexpr std::array<char, 4> kMagic = {'F', 'C', 'N', 'N'};
+constexpr std::array<std::uint32_t, 4> kHeader = {
+    /*version=*/1,
+    kNumFeatures,
+    kL1Size,
+    kL2Size,
+};
+
+// Activations are clipped to [0, kMaxActivation] before each dense layer, so
+// that they fit in a uint8.
+constexpr int kMaxActivation = 127;
+
+// The dense layer outputs are divided by these before clipping (as shifts)
+// and before being returned as a score, respectively.
+constexpr int kHiddenShift = 6;
+constexpr int kOutputScale = 16;
+
+template <typename T, std::size_t Extent>
+bool Read(std::istream& input, std::span<T, Extent> values) {
+  return static_cast<bool>(input.read(reinterpret_cast<char*>(values.data()),
+                                      values.size_bytes()));
+}
+
+template <typename T, std::size_t Extent>
+void Write(std::ostream& output, std::span<const T, Extent> values) {
+  output.write(reinterpret_cast<const char*>(values.data()),
+               values.size_bytes());
+}
+
+// Returns the input of the feature transformer for a piece, as seen from the
+// given perspective. Black's perspective mirrors the board, so that both sides
+// see their own pieces in the same way.
+int GetFeature(const Side perspective, Square king, const Side side,
+               const Piece piece, Square square) {
+  if (perspective == kBlack) {
+    king = Reflect(king);
+    square = Reflect(square);
+  }
+  const int relative_side = side == perspective ? 0 : 1;
+  return ((king * kNumSides + relative_side) * kNumPieces + piece) *
+             kNumSquares +
+         square;
+}
+
+int DotScalar(const std::uint8_t* input, const std::int8_t* weights,
+              const int size) {
+  int sum = 0;
+  for (int i = 0; i < size; ++i) {
+    sum += input[i] * weights[i];
+  }
+  return sum;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Multiplies unsigned 8-bit inputs by signed 8-bit weights, and adds adjacent
+// products into 32-bit lanes. The intermediate 16-bit sums cannot saturate,
+// since the inputs are at most kMaxActivation.
+//
+// The target attributes let these compile without the instruction sets being
+// enabled for the whole build. They must only run on CPUs that support them.
+[[gnu::target("avx2")]] int DotAvx2(const std::uint8_t* input,
+                                    const std::int8_t* weights,
+                                    const int size) {
+  DCHECK_EQ(size % 32, 0);
+  const __m256i ones = _mm256_set1_epi16(1);
+  __m256i sum = _mm256_setzero_si256();
+  for (int i = 0; i < size; i += 32) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+    sum = _mm256_add_epi32(
+        sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+  }
+
+  __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                 _mm256_extracti128_si256(sum, 1));
+  sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b01'00'11'10));
+  sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b10'11'00'01));
+  return _mm_cvtsi128_si32(sum128);
+}
+
+[[gnu::target("sse4.1")]] int DotSse41(const std::uint8_t* input,
+                                       const std::int8_t* weights,
+                                       const int size) {
+  DCHECK_EQ(size % 16, 0);
+  const __m128i ones = _mm_set1_epi16(1);
+  __m128i sum = _mm_setzero_si128();
+  for (int i = 0; i < size; i += 16) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(a, b), ones));
+  }
+
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0b01'00'11'10));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0b10'11'00'01));
+  return _mm_cvtsi128_si32(sum);
+}
+#else
+int DotAvx2(const std::uint8_t* input, const std::int8_t* weights,
+            const int size) {
+  return DotScalar(input, weights, size);
+}
+
+int DotSse41(const std::uint8_t* input, const std::int8_t* weights,
+             const int size) {
+  return DotScalar(input, weights, size);
+}
+#endif
+
+template <int (*Dot)(const std::uint8_t*, const std::int8_t*, int)>
+int Forward(const Network& network, const Side side_to_move,
+            const Accumulator& accumulator) {
+  alignas(32) std::array<std::uint8_t, 2 * kL1Size> input;
+  const std::array<Side, kNumSides> perspectives = {side_to_move,
+                                                    ~side_to_move};
+  for (int i = 0; i < kNumSides; ++i) {
+    const std::span<const std::int16_t, kL1Size> values =
+        accumulator.Get(perspectives[i]);
+    for (int j = 0; j < kL1Size; ++j) {
+      input[i * kL1Size + j] =
+          std::clamp<int>(values[j], 0, kMaxActivation);
+    }
+  }
+
+  alignas(32) std::array<std::uint8_t, kL2Size> hidden;
+  for (int i = 0; i < kL2Size; ++i) {
+    const int sum =
+        network.hidden_biases[i] +
+        Dot(input.data(), &network.hidden_weights[i * input.size()],
+            input.size());
+    hidden[i] = std::clamp(sum >> kHiddenShift, 0, kMaxActivation);
+  }
+
+  const int output =
+      network.output_bias +
+      Dot(hidden.data(), network.output_weights.data(), hidden.size());
+  return output / kOutputScale;
+}
+
+}  // namespace
+
+std::expected<Network, std::string> Network::Load(
+    const std::filesystem::path& path) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    return std::unexpected(
+        std::format("Could not open network file: {}", path.string()));
+  }
+
+  std::array<char, kMagic.size()> magic;
+  std::array<std::uint32_t, kHeader.size()> header;
+  if (!Read(input, std::span(magic)) || magic != kMagic ||
+      !Read(input, std::span(header)) || header != kHeader) {
+    return std::unexpected(
+        std::format("Invalid network file: {}", path.string()));
+  }
+
+  Network network;
+  if (!Read(input, std::span(network.feature_biases)) ||
+      !Read(input, std::span(network.feature_weights)) ||
+      !Read(input, std::span(network.hidden_biases)) ||
+      !Read(input, std::span(network.hidden_weights)) ||
+      !Read(input, std::span(&network.output_bias, 1)) ||
+      !Read(input, std::span(network.output_weights))) {
+    return std::unexpected(
+        std::format("Truncated network file: {}", path.string()));
+  }
+
+  if (input.peek() != std::ifstream::traits_type::eof()) {
+    return std::unexpected(
+        std::format("Invalid network file: {}", path.string()));
+  }
+  return network;
+}
+
+std::expected<void, std::string> Network::Save(
+    const std::filesystem::path& path) const {
+  std::ofstream output(path, std::ios::binary);
+  Write(output, std::span(kMagic));
+  Write(output, std::span(kHeader));
+  Write(output, std::span(feature_biases));
+  Write(output, std::span(feature_weights));
+  Write(output, std::span(hidden_biases));
+  Write(output, std::span(hidden_weights));
+  Write(output, std::span(&output_bias, 1));
+  Write(output, std::span(output_weights));
+
+  if (!output) {
+    return std::unexpected(
+        std::format("Could not write network file: {}", path.string()));
+  }
+  return {};
+}
+
+Accumulator::Accumulator(const Network& network, const Position& position) {
+  Refresh(network, position, kWhite);
+  Refresh(network, position, kBlack);
+}
+
+Accumulator Accumulator::After(const Network& network,
+                               const Position& position,
+                               const Move move) const {
+  Accumulator result = *this;
+  if (move.IsNullMove()) {
+    return result;
+  }
+
+  const Side side = position.SideToMove();
+  const Square from = move.GetFrom();
+  const Square to = move.GetTo();
+  const Piece piece = position.GetPiece(from);
+
+  // The features of a perspective depend on the square of its king, so all
+  // of them change when the king moves.
+  const bool king_moved = piece == kKing;
+  if (king_moved) {
+    Position after = position;
+    after.Do(move);
+    result.Refresh(network, after, side);
+  }
+
+  const auto update = [&](const Side piece_side, const Piece piece,
+                          const Square square, const bool add) {
+    for (const Side perspective : {kWhite, kBlack}) {
+      if (king_moved && perspective == side) {
+        continue;
+      }
+      const int feature = GetFeature(perspective, position.GetKing(perspective),
+                                     piece_side, piece, square);
+      if (add) {
+        result.Add(network, perspective, feature);
+      } else {
+        result.Remove(network, perspective, feature);
+      }
+    }
+  };
+
+  if (const Piece captured = position.GetPiece(to); captured != kEmptyPiece) {
+    update(~side, captured, to, /*add=*/false);
+  }
+  if (move.IsEnPassantCapture()) {
+    update(~side, kPawn, move.GetEnPassantVictim(), /*add=*/false);
+  }
+
+  update(side, piece, from, /*add=*/false);
+  update(side, move.IsPromotion() ? move.GetPromotedPiece() : piece, to,
+         /*add=*/true);
+
+  if (move.IsCastling()) {
+    static constexpr Square kKingSideRooks[kNumSides][2] = {{H1, F1},
+                                                            {H8, F8}};
+    static constexpr Square kQueenSideRooks[kNumSides][2] = {{A1, D1},
+                                                             {A8, D8}};
+    const auto& [rook_from, rook_to] = move.IsKingSideCastling()
+                                           ? kKingSideRooks[side]
+                                           : kQueenSideRooks[side];
+    update(side, kRook, rook_from, /*add=*/false);
+    update(side, kRook, rook_to, /*add=*/true);
+  }
+
+  return result;
+}
+
+void Accumulator::Refresh(const Network& network, const Position& position,
+                          const Side perspective) {
+  std::ranges::copy(network.feature_biases, values_[perspective].begin());
+
+  const Square king = position.GetKing(perspective);
+  for (const Side side : {kWhite, kBlack}) {
+    for (int piece = kPawn; piece <= kKing; ++piece) {
+      Bitboard pieces = position.GetPieces(side, static_cast<Piece>(piece));
+      while (pieces) {
+        Add(network, perspective,
+            GetFeature(perspective, king, side, static_cast<Piece>(piece),
+                       pieces.PopLeastSignificantBit()));
+      }
+    }
+  }
+}
+
+// The compiler vectorizes the loops below, so they need no intrinsics.
+void Accumulator::Add(const Network& network, const Side perspective,
+                      const int feature) {
+  const std::int16_t* weights = &network.feature_weights[feature * kL1Size];
+  for (int i = 0; i < kL1Size; ++i) {
+    values_[perspective][i] += weights[i];
+  }
+}
+
+void Accumulator::Remove(const Network& network, const Side perspective,
+                         const int feature) {
+  const std::int16_t* weights = &network.feature_weights[feature * kL1Size];
+  for (int i = 0; i < kL1Size; ++i) {
+    values_[perspective][i] -= weights[i];
+  }
+}
+
+bool IsSupported(const Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kScalar:
+      return true;
+    case Kernel::kSse41:
+      return GetCpuFeatures().sse4_1;
+    case Kernel::kAvx2:
+      return GetCpuFeatures().avx2;
+  }
+  return false;
+}
+
+Kernel GetBestKernel() {
+  static const Kernel kBestKernel = [] {
+    for (const Kernel kernel : {Kernel::kAvx2, Kernel::kSse41}) {
+      if (IsSupported(kernel)) {
+        return kernel;
+      }
+    }
+    return Kernel::kScalar;
+  }();
+  return kBestKernel;
+}
+
+std::string_view ToString(const Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kScalar:
+      return "scalar";
+    case Kernel::kSse41:
+      return "sse4.1";
+    case Kernel::kAvx2:
+      return "avx2";
+  }
+  return "";
+}
+
+int Evaluate(const Network& network, const Position& position,
+             const Accumulator& accumulator, const Kernel kernel) {
+  DCHECK(accumulator == Accumulator(network, position));
+  DCHECK(IsSupported(kernel));
+  switch (kernel) {
+    case Kernel::kScalar:
+      return Forward<DotScalar>(network, position.SideToMove(), accumulator);
+    case Kernel::kSse41:
+      return Forward<DotSse41>(network, position.SideToMove(), accumulator);
+    case Kernel::kAvx2:
+      return Forward<DotAvx2>(network, position.SideToMove(), accumulator);
+  }
+  return 0;
+}
+
+}  // namespace nnue
+}  // namespace follychess
@@ -0,0 +1,144 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_NNUE_H_
+#define FOLLYCHESS_SEARCH_NNUE_H_
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess {
+namespace nnue {
+
+// The network has the following layers:
+//
+//   * A feature transformer with one input per (king square, piece side,
+//     piece, piece square) tuple, seen from each side's perspective (i.e.,
+//     HalfKA). Each perspective sums the int16 weights of its active features
+//     into kL1Size values. These sums are kept up to date incrementally as
+//     moves are made (see Accumulator).
+//
+//   * A dense layer that takes both perspectives, the side to move first,
+//     clipped to [0, 127], and computes kL2Size outputs from int8 weights.
+//
+//   * A dense output layer that takes the kL2Size outputs, also clipped to
+//     [0, 127], and computes the score from int8 weights.
+//
+// Each perspective is mirrored, so that the network always sees the board
+// from its own side.
+inline constexpr int kNumFeatures =
+    kNumSquares * kNumSides * kNumPieces * kNumSquares;
+inline constexpr int kL1Size = 256;
+inline constexpr int kL2Size = 32;
+
+// The quantized weights of a network.
+//
+// A network file starts with the magic bytes "FCNN", followed by a format
+// version and the layer sizes as little-endian uint32 values. The weights
+// follow in the order of the fields below, as little-endian integers. Weights
+// of dense layers are stored one output at a time.
+struct Network {
+  // Reads a network from the given file.
+  static std::expected<Network, std::string> Load(
+      const std::filesystem::path& path);
+
+  // Writes the network in the format read by Load().
+  std::expected<void, std::string> Save(
+      const std::filesystem::path& path) const;
+
+  std::vector<std::int16_t> feature_biases =
+      std::vector<std::int16_t>(kL1Size);
+  std::vector<std::int16_t> feature_weights =
+      std::vector<std::int16_t>(kNumFeatures * kL1Size);
+
+  std::vector<std::int32_t> hidden_biases = std::vector<std::int32_t>(kL2Size);
+  std::vector<std::int8_t> hidden_weights =
+      std::vector<std::int8_t>(kL2Size * 2 * kL1Size);
+
+  std::int32_t output_bias = 0;
+  std::vector<std::int8_t> output_weights = std::vector<std::int8_t>(kL2Size);
+};
+
+// The feature transformer output of a position, for both perspectives.
+class Accumulator {
+ public:
+  // Computes the accumulator from scratch.
+  Accumulator(const Network& network, const Position& position);
+
+  // Returns the accumulator of the position after `move` is made. `position`
+  // must be the position before the move, and `move` must be legal in it.
+  // Only the changed features are updated, except for the perspective of a
+  // side whose king moves, which is recomputed.
+  [[nodiscard]] Accumulator After(const Network& network,
+                                  const Position& position, Move move) const;
+
+  [[nodiscard]] std::span<const std::int16_t, kL1Size> Get(
+      const Side perspective) const {
+    return values_[perspective];
+  }
+
+  bool operator==(const Accumulator& other) const = default;
+
+ private:
+  void Refresh(const Network& network, const Position& position,
+               Side perspective);
+
+  void Add(const Network& network, Side perspective, int feature);
+
+  void Remove(const Network& network, Side perspective, int feature);
+
+  std::array<std::array<std::int16_t, kL1Size>, kNumSides> values_;
+};
+
+// Selects the implementation of the dense layers. All kernels are compiled
+// into every x86 binary, whatever instruction sets the build enables.
+enum class Kernel : std::uint8_t {
+  kScalar,
+  kSse41,
+  kAvx2,
+};
+
+// Returns true if the CPU can run the kernel.
+[[nodiscard]] bool IsSupported(Kernel kernel);
+
+// Returns the fastest kernel that the CPU supports, as detected by CPUID on
+// the first call.
+[[nodiscard]] Kernel GetBestKernel();
+
+[[nodiscard]] std::string_view ToString(Kernel kernel);
+
+// Returns the score of the position in centipawns, relative to the side to
+// move. `accumulator` must describe `position`. All kernels return the same
+// score, and `kernel` must be supported by the CPU.
+[[nodiscard]] int Evaluate(const Network& network, const Position& position,
+                           const Accumulator& accumulator,
+                           Kernel kernel = GetBestKernel());
+
+}  // namespace nnue
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_NNUE_H_
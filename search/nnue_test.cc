@@ -0,0 +1,166 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/nnue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "engine/move.h"
+#include "engine/move_generator.h"
+#include "engine/position.h"
+#include "engine/scoped_move.h"
+#include "search/nnue_testing.h"
+
+namespace follychess {
+namespace nnue {
+namespace {
+
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::IsTrue;
+
+constexpr std::array<std::string_view, 4> kFens = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    "r3k2r/1P4P1/8/8/8/8/1p4p1/R3K2R b KQkq - 0 1",
+};
+
+class NnueTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { network_ = new Network(MakeRandomNetwork()); }
+
+  static void TearDownTestSuite() {
+    delete network_;
+    network_ = nullptr;
+  }
+
+  static const Network& network() { return *network_; }
+
+ private:
+  static Network* network_;
+};
+
+Network* NnueTest::network_ = nullptr;
+
+TEST_F(NnueTest, SaveAndLoad) {
+  const std::filesystem::path path =
+      std::filesystem::path(::testing::TempDir()) / "save_and_load.nnue";
+  ASSERT_THAT(network().Save(path).error_or(""), IsEmpty());
+
+  const std::expected<Network, std::string> loaded = Network::Load(path);
+  ASSERT_THAT(loaded.error_or(""), IsEmpty());
+  EXPECT_THAT(loaded->feature_biases, Eq(network().feature_biases));
+  EXPECT_THAT(loaded->feature_weights, Eq(network().feature_weights));
+  EXPECT_THAT(loaded->hidden_biases, Eq(network().hidden_biases));
+  EXPECT_THAT(loaded->hidden_weights, Eq(network().hidden_weights));
+  EXPECT_THAT(loaded->output_bias, Eq(network().output_bias));
+  EXPECT_THAT(loaded->output_weights, Eq(network().output_weights));
+}
+
+TEST_F(NnueTest, LoadErrors) {
+  const std::filesystem::path directory = ::testing::TempDir();
+  EXPECT_THAT(Network::Load(directory / "missing.nnue").error_or(""),
+              HasSubstr("Could not open network file"));
+
+  const std::filesystem::path invalid = directory / "invalid.nnue";
+  std::ofstream(invalid) << "not a network";
+  EXPECT_THAT(Network::Load(invalid).error_or(""),
+              HasSubstr("Invalid network file"));
+
+  const std::filesystem::path truncated = directory / "truncated.nnue";
+  ASSERT_THAT(network().Save(truncated).error_or(""), IsEmpty());
+  std::filesystem::resize_file(truncated,
+                               std::filesystem::file_size(truncated) - 1);
+  EXPECT_THAT(Network::Load(truncated).error_or(""),
+              HasSubstr("Truncated network file"));
+
+  const std::filesystem::path trailing = directory / "trailing.nnue";
+  ASSERT_THAT(network().Save(trailing).error_or(""), IsEmpty());
+  std::ofstream(trailing, std::ios::app) << "x";
+  EXPECT_THAT(Network::Load(trailing).error_or(""),
+              HasSubstr("Invalid network file"));
+}
+
+TEST_F(NnueTest, IncrementalUpdatesMatchRefresh) {
+  for (std::string_view fen : kFens) {
+    Position position = Position::FromFen(fen).value();
+    const Accumulator accumulator(network(), position);
+
+    for (const Move move : GenerateLegalMoves(position)) {
+      const Accumulator next = accumulator.After(network(), position, move);
+      ScopedMove scoped_move(move, position);
+      EXPECT_THAT(next, Eq(Accumulator(network(), position)))
+          << fen << " " << move;
+    }
+  }
+}
+
+TEST_F(NnueTest, KernelsAgree) {
+  for (const Kernel kernel : {Kernel::kSse41, Kernel::kAvx2}) {
+    if (!IsSupported(kernel)) {
+      continue;
+    }
+    for (std::string_view fen : kFens) {
+      Position position = Position::FromFen(fen).value();
+      for (const Move move : GenerateLegalMoves(position)) {
+        ScopedMove scoped_move(move, position);
+        const Accumulator accumulator(network(), position);
+        EXPECT_THAT(Evaluate(network(), position, accumulator, kernel),
+                    Eq(Evaluate(network(), position, accumulator,
+                                Kernel::kScalar)))
+            << ToString(kernel) << " " << fen << " " << move;
+      }
+    }
+  }
+}
+
+TEST(Kernel, BestKernelIsSupported) {
+  EXPECT_THAT(IsSupported(GetBestKernel()), IsTrue());
+  EXPECT_THAT(IsSupported(Kernel::kScalar), IsTrue());
+}
+
+TEST_F(NnueTest, MirroredPositionsHaveSameScore) {
+  constexpr std::array<std::array<std::string_view, 2>, 2> kMirroredFens = {{
+      {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+       "r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1"},
+      {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+       "rnbqkbnr/pppp1ppp/8/8/3PpP2/8/PPP1P1PP/RNBQKBNR b KQkq f3 0 3"},
+  }};
+
+  for (const auto& [fen, mirrored_fen] : kMirroredFens) {
+    const Position position = Position::FromFen(fen).value();
+    const Position mirrored = Position::FromFen(mirrored_fen).value();
+    EXPECT_THAT(
+        Evaluate(network(), position, Accumulator(network(), position)),
+        Eq(Evaluate(network(), mirrored, Accumulator(network(), mirrored))))
+        << fen;
+  }
+}
+
+}  // namespace
+}  // namespace nnue
+}  // namespace follychess
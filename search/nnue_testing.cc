@@ -0,0 +1,53 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/nnue_testing.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "search/nnue.h"
+
+namespace follychess {
+namespace nnue {
+namespace {
+
+template <typename T>
+void Fill(std::vector<T>& values, const int limit, std::mt19937& engine) {
+  std::uniform_int_distribution<int> dist(-limit, limit);
+  for (T& value : values) {
+    value = static_cast<T>(dist(engine));
+  }
+}
+
+}  // namespace
+
+Network MakeRandomNetwork(const std::uint32_t seed) {
+  std::mt19937 engine(seed);
+  Network network;
+  Fill(network.feature_biases, 32, engine);
+  Fill(network.feature_weights, 32, engine);
+  Fill(network.hidden_biases, 1024, engine);
+  Fill(network.hidden_weights, 8, engine);
+  network.output_bias = std::uniform_int_distribution<int>(-64, 64)(engine);
+  Fill(network.output_weights, 8, engine);
+  return network;
+}
+
+}  // namespace nnue
+}  // namespace follychess
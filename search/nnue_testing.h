@@ -0,0 +1,36 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_NNUE_TESTING_H_
+#define FOLLYCHESS_SEARCH_NNUE_TESTING_H_
+
+#include <cstdint>
+
+#include "search/nnue.h"
+
+namespace follychess {
+namespace nnue {
+
+// Returns a network with random weights, for tests and benchmarks that need a
+// network but not a meaningful evaluation. The same seed always produces the
+// same network.
+[[nodiscard]] Network MakeRandomNetwork(std::uint32_t seed = 0);
+
+}  // namespace nnue
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_NNUE_TESTING_H_
@@ -22,25 +22,24 @@
 namespace follychess {
 namespace {
 
-constexpr int kKnightMaterialScore = 1;
-constexpr int kBishopMaterialScore = 1;
-constexpr int kRookMaterialScore = 2;
-constexpr int kQueenMaterialScore = 4;
-
-constexpr int kStartMaterialScore = 4 * kKnightMaterialScore +  //
-                                    4 * kBishopMaterialScore +  //
-                                    4 * kRookMaterialScore +    //
-                                    2 * kQueenMaterialScore;
+constexpr int kStartMaterialScore = 4 * kPhaseMaterialScores[kKnight] +  //
+                                    4 * kPhaseMaterialScores[kBishop] +  //
+                                    4 * kPhaseMaterialScores[kRook] +    //
+                                    2 * kPhaseMaterialScores[kQueen];
 
 }  // namespace
 
 int CalculatePhase(const Position& position) {
-  int phase = kStartMaterialScore;
-  phase -= position.GetPieces(kKnight).GetCount() * kKnightMaterialScore;
-  phase -= position.GetPieces(kBishop).GetCount() * kBishopMaterialScore;
-  phase -= position.GetPieces(kRook).GetCount() * kRookMaterialScore;
-  phase -= position.GetPieces(kQueen).GetCount() * kQueenMaterialScore;
+  int phase_material = 0;
+  for (const Piece piece : {kKnight, kBishop, kRook, kQueen}) {
+    phase_material +=
+        position.GetPieces(piece).GetCount() * kPhaseMaterialScores[piece];
+  }
+  return CalculatePhase(phase_material);
+}
 
+int CalculatePhase(const int phase_material) {
+  int phase = kStartMaterialScore - phase_material;
   phase = phase * kEndPhaseValue + kStartMaterialScore / 2;
   phase /= kStartMaterialScore;
   return phase;
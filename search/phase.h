@@ -18,13 +18,27 @@
 #ifndef FOLLYCHESS_SEARCH_PHASE_H_
 #define FOLLYCHESS_SEARCH_PHASE_H_
 
+#include <array>
+
 #include "engine/position.h"
+#include "engine/types.h"
 
 namespace follychess {
 
 constexpr int kStartPhaseValue = 0;
 constexpr int kEndPhaseValue = 256;
 
+// How much each piece counts towards the phase material. Pawns and kings do
+// not count.
+constexpr std::array<int, kNumPieces> kPhaseMaterialScores = {
+    0,  // Pawn
+    1,  // Knight
+    1,  // Bishop
+    2,  // Rook
+    4,  // Queen
+    0,  // King
+};
+
 // Calculates the game phase based on material. Returns 0 for the starting
 // position and 256 for a position with only kings. All other positions
 // return an interpolated value.
@@ -33,6 +47,10 @@ constexpr int kEndPhaseValue = 256;
 // https://www.chessprogramming.org/Tapered_Eval.
 [[nodiscard]] int CalculatePhase(const Position& position);
 
+// Like above, but takes the sum of kPhaseMaterialScores over all pieces on
+// the board.
+[[nodiscard]] int CalculatePhase(int phase_material);
+
 }  // namespace follychess
 
 #endif  // FOLLYCHESS_SEARCH_PHASE_H_
@@ -66,6 +66,12 @@ class PrincipalVariationTable {
 
   [[nodiscard]] Move GetBestMove() const { return data_[0]; }
 
+  // Shortens the principal variation to its first `size` moves.
+  void Truncate(std::size_t size) {
+    DCHECK_LE(size, GetPrincipalVariation().size());
+    data_[size] = Move::NullMove();
+  }
+
  private:
   [[nodiscard]] static int GetIndex(int ply) {
     return ply * kMaxDepth - (ply * (ply - 1)) / 2;
@@ -67,5 +67,16 @@ TEST(PrincipalVariationTable, Replacement) {
               ElementsAreArray(MakeMoves({"d2d4", "d7d5"})));
 }
 
+TEST(PrincipalVariationTable, Truncate) {
+  PrincipalVariationTable table;
+  table.RecordMove(2, MakeMove("b1c3"));
+  table.RecordMove(1, MakeMove("d7d5"));
+  table.RecordMove(0, MakeMove("e2e4"));
+
+  table.Truncate(1);
+  EXPECT_THAT(table.GetPrincipalVariation(),
+              ElementsAreArray(MakeMoves({"e2e4"})));
+}
+
 }  // namespace
 }  // namespace follychess
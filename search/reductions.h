@@ -0,0 +1,102 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_REDUCTIONS_H_
+#define FOLLYCHESS_SEARCH_REDUCTIONS_H_
+
+#include <algorithm>
+#include <array>
+
+namespace follychess {
+
+// The natural logarithm of `x` >= 1. std::log() is not usable in constant
+// expressions, so this reduces `x` to [1, 2) and sums the series of
+// ln(x) = 2 * atanh((x - 1) / (x + 1)).
+consteval double Log(double x) {
+  constexpr double kLog2 = 0.6931471805599453;
+  int exponent = 0;
+  while (x >= 2) {
+    x /= 2;
+    ++exponent;
+  }
+
+  const double y = (x - 1) / (x + 1);
+  double term = y;
+  double sum = 0;
+  for (int n = 1; n < 64; n += 2) {
+    sum += term / n;
+    term *= y * y;
+  }
+  return exponent * kLog2 + 2 * sum;
+}
+
+// Late move reductions are indexed by depth and move count up to these
+// bounds. Larger values share the last entry.
+constexpr int kMaxReductionDepth = 64;
+constexpr int kMaxReductionMoveCount = 64;
+
+consteval auto GenerateLateMoveReductionTable() {
+  std::array<std::array<int, kMaxReductionMoveCount>, kMaxReductionDepth>
+      reductions = {};
+  for (int depth = 1; depth < kMaxReductionDepth; ++depth) {
+    for (int move_count = 1; move_count < kMaxReductionMoveCount;
+         ++move_count) {
+      reductions[depth][move_count] = static_cast<int>(
+          0.75 + Log(depth) * Log(move_count) / 2.25);
+    }
+  }
+  return reductions;
+}
+
+// Returns by how many plies to reduce the search of the `move_count`-th move
+// (counting from one) of a node searched to `depth`. Moves ordered late
+// rarely turn out best, so the later the move and the deeper the node, the
+// larger the reduction.
+constexpr int GetLateMoveReduction(const int depth, const int move_count) {
+  static constexpr std::array<std::array<int, kMaxReductionMoveCount>,
+                              kMaxReductionDepth>
+      kReductionTable = GenerateLateMoveReductionTable();
+  return kReductionTable[std::clamp(depth, 0, kMaxReductionDepth - 1)]
+                        [std::clamp(move_count, 0, kMaxReductionMoveCount - 1)];
+}
+
+// Late move pruning only applies to nodes at most this deep.
+constexpr int kMaxLateMovePruningDepth = 3;
+
+consteval auto GenerateLateMovePruningTable() {
+  std::array<int, kMaxLateMovePruningDepth + 1> counts = {};
+  for (int depth = 1; depth <= kMaxLateMovePruningDepth; ++depth) {
+    counts[depth] = 3 + depth * depth;
+  }
+  return counts;
+}
+
+// Returns after how many moves the remaining quiet moves of a node searched to
+// `depth` are no longer searched. Returns zero if no moves are pruned at this
+// depth.
+constexpr int GetLateMovePruningCount(const int depth) {
+  static constexpr std::array<int, kMaxLateMovePruningDepth + 1> kCountTable =
+      GenerateLateMovePruningTable();
+  if (depth < 1 || depth > kMaxLateMovePruningDepth) {
+    return 0;
+  }
+  return kCountTable[depth];
+}
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_REDUCTIONS_H_
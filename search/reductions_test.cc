@@ -0,0 +1,74 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/reductions.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Gt;
+
+TEST(Log, MatchesKnownValues) {
+  static_assert(Log(1) == 0);
+  EXPECT_NEAR(Log(2), 0.693147, 1e-6);
+  EXPECT_NEAR(Log(10), 2.302585, 1e-6);
+  EXPECT_NEAR(Log(63), 4.143135, 1e-6);
+}
+
+TEST(GetLateMoveReduction, DoesNotReduceTheFirstMove) {
+  for (int depth = 0; depth < kMaxReductionDepth; ++depth) {
+    EXPECT_THAT(GetLateMoveReduction(depth, 1), Eq(0)) << "depth: " << depth;
+  }
+}
+
+TEST(GetLateMoveReduction, GrowsWithDepthAndMoveCount) {
+  EXPECT_THAT(GetLateMoveReduction(3, 4), Eq(1));
+  EXPECT_THAT(GetLateMoveReduction(10, 40), Eq(4));
+
+  for (int depth = 1; depth < kMaxReductionDepth - 1; ++depth) {
+    for (int move_count = 1; move_count < kMaxReductionMoveCount - 1;
+         ++move_count) {
+      EXPECT_THAT(GetLateMoveReduction(depth + 1, move_count),
+                  Ge(GetLateMoveReduction(depth, move_count)));
+      EXPECT_THAT(GetLateMoveReduction(depth, move_count + 1),
+                  Ge(GetLateMoveReduction(depth, move_count)));
+    }
+  }
+}
+
+TEST(GetLateMoveReduction, ClampsLargeValues) {
+  EXPECT_THAT(GetLateMoveReduction(200, 200),
+              Eq(GetLateMoveReduction(kMaxReductionDepth - 1,
+                                      kMaxReductionMoveCount - 1)));
+}
+
+TEST(GetLateMovePruningCount, OnlyPrunesShallowNodes) {
+  EXPECT_THAT(GetLateMovePruningCount(0), Eq(0));
+  EXPECT_THAT(GetLateMovePruningCount(1), Eq(4));
+  EXPECT_THAT(GetLateMovePruningCount(2), Eq(7));
+  EXPECT_THAT(GetLateMovePruningCount(3), Eq(12));
+  EXPECT_THAT(GetLateMovePruningCount(kMaxLateMovePruningDepth + 1), Eq(0));
+  EXPECT_THAT(GetLateMovePruningCount(2), Gt(GetLateMovePruningCount(1)));
+}
+
+}  // namespace
+}  // namespace follychess
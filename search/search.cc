@@ -17,26 +17,129 @@
 
 #include "search/search.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
 #include <vector>
 
+#include "engine/game.h"
 #include "engine/move.h"
 #include "engine/move_generator.h"
 #include "engine/position.h"
-#include "engine/scoped_move.h"
 #include "engine/types.h"
+#include "search/eval_cache.h"
 #include "search/evaluation.h"
 #include "search/history_heuristic.h"
+#include "search/hit_counter.h"
 #include "search/killer_moves.h"
-#include "search/move_ordering.h"
-#include "search/phase.h"
+#include "search/move_picker.h"
+#include "search/nnue.h"
 #include "search/principal_variation.h"
+#include "search/reductions.h"
+#include "search/time_manager.h"
 #include "search/transposition.h"
 
 namespace follychess {
+
+// State owned by a single search thread. Each thread walks its own copy of
+// the game and keeps its own move ordering heuristics. Contexts outlive a
+// single search, so the history heuristic carries over to the next one.
+struct ThreadContext {
+  // Prepares the context for a new search of the given game.
+  void Reset(const Game& new_game, const SearchOptions& options) {
+    game = new_game;
+    accumulators.clear();
+    nnue_accumulators.clear();
+    if (options.network) {
+      nnue_accumulators.emplace_back(*options.network, game.GetPosition());
+    } else {
+      accumulators.emplace_back(game.GetPosition());
+    }
+    killer_moves = KillerMoves();
+    pv_table = PrincipalVariationTable();
+    history_heuristic.Age();
+    pawn_hash_table.ResetMetrics();
+    if (eval_cache.size_mb() != options.eval_cache_size_mb) {
+      eval_cache.Resize(options.eval_cache_size_mb);
+    } else if (network != options.network) {
+      // The cached scores came from a different evaluation function.
+      eval_cache.Clear();
+    }
+    eval_cache.ResetMetrics();
+    transposition_table_hits.Reset();
+    network = options.network;
+    nodes.store(0, std::memory_order_relaxed);
+  }
+
+  Game game;
+
+  // The evaluation accumulator of each position on the path from the root to
+  // the current position of `game`.
+  std::vector<EvaluationAccumulator> accumulators;
+
+  // If set, positions are evaluated with this network instead, and
+  // `nnue_accumulators` is maintained instead of `accumulators`.
+  std::shared_ptr<const nnue::Network> network;
+  std::vector<nnue::Accumulator> nnue_accumulators;
+
+  KillerMoves killer_moves;
+  PrincipalVariationTable pv_table;
+  HistoryHeuristic history_heuristic;
+  PawnHashTable pawn_hash_table;
+  EvalCache eval_cache;
+
+  // Counts this thread's probes of the shared transposition table. Shared
+  // counters would make all threads contend on one cache line at every node.
+  HitCounter transposition_table_hits;
+
+  // Written only by the owning thread, but read by the main thread when
+  // reporting search info.
+  std::atomic<std::int64_t> nodes = 0;
+};
+
 namespace {
 
+// Makes a move in the thread's game and updates the evaluation accumulators
+// to match. Both are undone when this goes out of scope.
+class ScopedSearchMove {
+ public:
+  ScopedSearchMove(const Move move, ThreadContext& context)
+      : context_(context) {
+    const Position& position = context.game.GetPosition();
+    if (context.network) {
+      context.nnue_accumulators.push_back(
+          context.nnue_accumulators.back().After(*context.network, position,
+                                                 move));
+    } else {
+      context.accumulators.push_back(
+          context.accumulators.back().After(position, move));
+    }
+    context.game.Do(move);
+  }
+
+  ~ScopedSearchMove() {
+    context_.game.Undo();
+    if (context_.network) {
+      context_.nnue_accumulators.pop_back();
+    } else {
+      context_.accumulators.pop_back();
+    }
+  }
+
+  ScopedSearchMove(const ScopedSearchMove&) = delete;
+
+  ScopedSearchMove& operator=(const ScopedSearchMove&) = delete;
+
+ private:
+  ThreadContext& context_;
+};
+
 std::optional<int> GetMateIn(const int score) {
   if (std::abs(score) < kCheckMateThreshold) {
     return std::nullopt;
@@ -50,36 +153,138 @@ std::optional<int> GetMateIn(const int score) {
   return moves;
 }
 
+// State shared by all search threads.
 struct SearchContext {
-  Game game;
-
   std::function<void(const SearchInfo&)> info_observer;
   std::chrono::steady_clock::time_point start_time;
 
-  KillerMoves killer_moves;
-  PrincipalVariationTable pv_table;
-  TranspositionTable transpositions;
-  HistoryHeuristic history_heuristic;
+  TranspositionTable& transpositions;
+  SearchFeatures features;
+
+  TimeControl time_control;
+  TimeManager time_manager;
+
+  // If set, the search stops after visiting about this many nodes.
+  std::optional<std::int64_t> max_nodes;
+
+  // Set once the search must end: by the main thread when it completes its
+  // last iteration or runs out of time or nodes, or by Searcher::Stop(). All
+  // threads abandon their current iteration as soon as they observe this,
+  // except for the main thread's first iteration, which always completes so
+  // that there is a move to play.
+  std::atomic<bool>& stop;
+
+  // Set while the search ponders. Cleared by Searcher::PonderHit().
+  std::atomic<bool>& pondering;
+
+  // The first thread is the main thread.
+  std::vector<ThreadContext*> threads;
 };
 
 class AlphaBetaSearcher {
  public:
-  explicit AlphaBetaSearcher(SearchContext& context)
-      : context_(context), nodes_(0) {}
+  AlphaBetaSearcher(SearchContext& shared, ThreadContext& context)
+      : shared_(shared),
+        context_(context),
+        is_main_thread_(&context == shared.threads.front()),
+        pondering_(shared.pondering.load(std::memory_order_relaxed)) {}
+
+  // Runs a single iteration of the search at the given depth. This is only
+  // called by the main thread. Returns nothing if the iteration was aborted,
+  // since its result is incomplete.
+  [[nodiscard]] std::optional<SearchResult> Search(const int depth) {
+    const int score = SearchRoot(depth);
+    if (Stopped()) {
+      return std::nullopt;
+    }
+    completed_iteration_ = true;
+    TruncateIllegalVariation();
+    shared_.info_observer(MakeSearchInfo(score, depth));
+
+    const std::span<const Move> variation =
+        context_.pv_table.GetPrincipalVariation();
+    DCHECK(!variation.empty());
+    return SearchResult{
+        .best_move = variation[0],
+        .ponder_move = variation.size() > 1 ? variation[1] : Move::NullMove(),
+    };
+  }
 
-  [[nodiscard]] Move Search(const int depth) {
-    constexpr int kAlpha = -100'000;
-    constexpr int kBeta = 100'000;
-    constexpr int kStartPly = 0;
-    const int score = Search(kAlpha, kBeta, depth, kStartPly);
-    context_.info_observer(MakeSearchInfo(score, depth));
+  // Moves below the root may come from transposition table cutoffs. Entries
+  // only match on part of the key, so a colliding entry can supply another
+  // position's move. The principal variation is cut before its first illegal
+  // move, so that neither the ponder move nor the reported variation is
+  // illegal.
+  void TruncateIllegalVariation() {
+    Position position = context_.game.GetPosition();
+    const std::span<const Move> variation =
+        context_.pv_table.GetPrincipalVariation();
+    for (std::size_t i = 0; i < variation.size(); ++i) {
+      if (!std::ranges::contains(GenerateLegalMoves(position), variation[i])) {
+        context_.pv_table.Truncate(i);
+        return;
+      }
+      (void)position.Do(variation[i]);
+    }
+  }
 
-    Move best_move = context_.pv_table.GetBestMove();
-    DCHECK_NE(best_move, Move::NullMove());
-    return best_move;
+  // Returns whether there is enough time left to run another iteration. This
+  // is only called by the main thread.
+  [[nodiscard]] bool CanStartIteration() {
+    return Pondering() || shared_.time_manager.CanStartIteration(
+                              std::chrono::steady_clock::now());
   }
 
+  // Runs a single iteration of the search at the given depth, discarding the
+  // result. Helper threads only contribute by populating the shared
+  // transposition table.
+  void SearchHelper(const int depth) { (void)SearchRoot(depth); }
+
  private:
+  [[nodiscard]] int SearchRoot(const int depth) {
+    // The window must fit within the 16-bit scores stored in the transposition
+    // table, since fail-hard bounds are recorded as is.
+    constexpr int kAlpha = -30'000;
+    constexpr int kBeta = 30'000;
+    constexpr int kStartPly = 0;
+
+    // The first iterations are cheap and their scores fluctuate the most, so
+    // they are searched with the full window.
+    constexpr int kMinAspirationDepth = 4;
+    constexpr int kInitialAspirationDelta = 25;
+    if (!shared_.features.aspiration_windows || depth < kMinAspirationDepth ||
+        !previous_score_) {
+      const int score = Search(kAlpha, kBeta, depth, kStartPly);
+      if (!Stopped()) {
+        previous_score_ = score;
+      }
+      return score;
+    }
+
+    // The search is fail-hard, so a score on either bound only says that the
+    // true score lies beyond it. The failing side is widened until the score
+    // falls strictly inside the window.
+    int delta = kInitialAspirationDelta;
+    int alpha = std::max(*previous_score_ - delta, kAlpha);
+    int beta = std::min(*previous_score_ + delta, kBeta);
+    while (true) {
+      const int score = Search(alpha, beta, depth, kStartPly);
+      if (Stopped()) {
+        return score;
+      }
+
+      delta *= 2;
+      if (score <= alpha && alpha > kAlpha) {
+        alpha = std::max(score - delta, kAlpha);
+      } else if (score >= beta && beta < kBeta) {
+        beta = std::min(score + delta, kBeta);
+      } else {
+        previous_score_ = score;
+        return score;
+      }
+    }
+  }
+
   // The main search routine.
   //
   // `depth` signifies how much work is left. Once `depth` becomes zero,
@@ -89,64 +294,135 @@ class AlphaBetaSearcher {
   [[nodiscard]] int Search(int alpha, const int beta, const int depth,
                            const int ply) {
     using enum TranspositionTable::BoundType;
-    ++nodes_;
+    CountNode();
 
     Move best_move;
-    if (std::optional<int> score =
-            context_.transpositions.Probe(context_.game.GetPosition().GetKey(),
-                                          {
-                                              .alpha = alpha,
-                                              .beta = beta,
-                                              .ply = ply,
-                                              .depth = depth,
-                                          },
-                                          &best_move)) {
+    const std::optional<int> transposition_score = ProbeTranspositions(
+        {.alpha = alpha, .beta = beta, .ply = ply, .depth = depth},
+        &best_move);
+
+    // The root only uses the table's move for ordering. Its key check is
+    // partial, so a colliding entry could yield an illegal best move. The
+    // stored score also ignores the game's repetitions, and a cutoff would
+    // leave no ponder move in the principal variation.
+    if (transposition_score && ply > 0) {
       context_.pv_table.RecordMove(ply, best_move);
-      return *score;
+      return *transposition_score;
     }
 
     context_.pv_table.RecordMove(ply, Move::NullMove());
 
     if (depth <= 0 && !CurrentSideInCheck()) {
       const int score = QuiescentSearch(alpha, beta, ply);
-      context_.transpositions.Record(context_.game.GetPosition().GetKey(),
-                                     score,
-                                     {
-                                         .ply = ply,
-                                         .depth = depth,
-                                     },
-                                     Exact, Move::NullMove());
+      if (Stopped()) {
+        return 0;
+      }
+      shared_.transpositions.Record(context_.game.GetPosition().GetKey(),
+                                    score,
+                                    {
+                                        .ply = ply,
+                                        .depth = depth,
+                                    },
+                                    Exact, Move::NullMove());
       return score;
     }
 
     if (NullPrune(depth, ply)) {
-      ScopedMove2 scoped_move(Move::NullMove(), context_.game);
+      PrefetchChild(Move::NullMove());
+      ScopedSearchMove scoped_move(Move::NullMove(), context_);
       constexpr int kDepthReduction = 2;
       const int next_depth = std::max(0, depth - 1 - kDepthReduction);
       const int score = -Search(-beta, -beta + 1, next_depth, ply + 1);
+      if (Stopped()) {
+        return 0;
+      }
       if (score >= beta) {
         return beta;
       }
     }
 
-    std::vector<Move> moves = GenerateLegalMoves(context_.game.GetPosition());
-    OrderMoves(context_.game.GetPosition(), best_move,
-               context_.killer_moves[ply], context_.history_heuristic, moves);
+    const KillerMoves::Entry& killer_moves = context_.killer_moves[ply];
+    MovePicker move_picker(context_.game.GetPosition(), best_move,
+                           killer_moves, context_.history_heuristic);
+
+    // Quiet moves after this many moves are considered late.
+    constexpr int kMinLateMoveCount = 3;
+    // Shallower nodes are cheap enough to search in full.
+    constexpr int kMinReductionDepth = 3;
+
+    // Only nodes searched with a null window lose moves to pruning, so that
+    // the principal variation is searched in full.
+    const bool in_check = CurrentSideInCheck();
+    const bool null_window = beta - alpha == 1;
+    const int late_move_pruning_count =
+        shared_.features.late_move_pruning && null_window && !in_check
+            ? GetLateMovePruningCount(depth)
+            : 0;
+    const bool can_reduce = shared_.features.late_move_reductions &&
+                            !in_check && depth >= kMinReductionDepth;
 
     TranspositionTable::BoundType transposition_type = UpperBound;
-    for (Move move : moves) {
-      ScopedMove2 scoped_move(move, context_.game);
-      const int score = -Search(-beta, -alpha, depth - 1, ply + 1);
+    int move_count = 0;
+    while (const std::optional<Move> next_move = move_picker.Next()) {
+      const Move move = *next_move;
+      ++move_count;
+
+      // The move picker hands out quiet moves after the captures and killer
+      // moves, so these are the moves that are least likely to matter.
+      const bool late_quiet_move =
+          move_count > kMinLateMoveCount && !move.IsCapture() &&
+          !move.IsPromotion() && move != killer_moves.first &&
+          move != killer_moves.second;
+      if (late_quiet_move && late_move_pruning_count > 0 &&
+          move_count > late_move_pruning_count &&
+          alpha > -kCheckMateThreshold) {
+        continue;
+      }
+
+      PrefetchChild(move);
+      int score;
+      {
+        ScopedSearchMove scoped_move(move, context_);
+
+        int reduction = 0;
+        if (can_reduce && late_quiet_move && !CurrentSideInCheck()) {
+          // The child must still be searched to at least one ply.
+          reduction = std::min(GetLateMoveReduction(depth, move_count),
+                               depth - 2);
+        }
+
+        if (move_count == 1 || !shared_.features.principal_variation_search) {
+          score = -Search(-beta, -alpha, depth - 1 - reduction, ply + 1);
+          if (reduction > 0 && score > alpha && !Stopped()) {
+            score = -Search(-beta, -alpha, depth - 1, ply + 1);
+          }
+        } else {
+          // The first move is most likely the best, so the others only need
+          // to be proven worse, which a null window does cheaply. Moves that
+          // turn out better are searched again to find their exact score.
+          score = -Search(-alpha - 1, -alpha, depth - 1 - reduction, ply + 1);
+          if (reduction > 0 && score > alpha && !Stopped()) {
+            score = -Search(-alpha - 1, -alpha, depth - 1, ply + 1);
+          }
+          if (score > alpha && score < beta && !Stopped()) {
+            score = -Search(-beta, -alpha, depth - 1, ply + 1);
+          }
+        }
+      }
+      if (Stopped()) {
+        // The result of an abandoned search must not be recorded.
+        return 0;
+      }
 
       if (score >= beta) {
         // Beta cutoff.
-        context_.transpositions.Record(context_.game.GetPosition().GetKey(),
-                                       score,
-                                       {
-                                           .ply = ply,
-                                           .depth = depth,
-                                       },
-                                       LowerBound, move);
+        shared_.transpositions.Record(context_.game.GetPosition().GetKey(),
+                                      score,
+                                      {
+                                          .ply = ply,
+                                          .depth = depth,
+                                      },
+                                      LowerBound, move);
         context_.killer_moves.Set(ply, move);
         context_.history_heuristic.Set(context_.game.GetPosition(), move,
                                        depth);
@@ -166,14 +442,14 @@ class AlphaBetaSearcher {
       return 0;
     }
 
-    if (!moves.empty()) {
-      context_.transpositions.Record(context_.game.GetPosition().GetKey(),
-                                     alpha,
-                                     {
-                                         .ply = ply,
-                                         .depth = depth,
-                                     },
-                                     transposition_type, best_move);
+    if (move_count > 0) {
+      shared_.transpositions.Record(context_.game.GetPosition().GetKey(),
+                                    alpha,
+                                    {
+                                        .ply = ply,
+                                        .depth = depth,
+                                    },
+                                    transposition_type, best_move);
       return alpha;
     }
 
@@ -187,7 +463,7 @@ class AlphaBetaSearcher {
 
   // NOLINTNEXTLINE(misc-no-recursion)
   [[nodiscard]] int QuiescentSearch(int alpha, const int beta, const int ply) {
-    ++nodes_;
+    CountNode();
     context_.pv_table.RecordMove(ply, Move::NullMove());
 
     int score = GetScore();
@@ -197,23 +473,22 @@ class AlphaBetaSearcher {
     alpha = std::max(alpha, score);
 
     Move best_move;
-    context_.transpositions.Probe(context_.game.GetPosition().GetKey(),
-                                  {
-                                      .alpha = alpha,
-                                      .beta = beta,
-                                      .ply = ply,
-                                      .depth = 0,
-                                  },
-                                  &best_move);
-
-    std::vector<Move> moves =
-        GenerateLegalMoves<kCapture>(context_.game.GetPosition());
-    OrderMoves(context_.game.GetPosition(), best_move,
-               context_.killer_moves[ply], context_.history_heuristic, moves);
-
-    for (Move move : moves) {
-      ScopedMove2 scoped_move(move, context_.game);
-      score = -QuiescentSearch(-beta, -alpha, ply + 1);
+    (void)ProbeTranspositions(
+        {.alpha = alpha, .beta = beta, .ply = ply, .depth = 0}, &best_move);
+
+    // Losing captures rarely raise alpha once the opponent recaptures.
+    MovePicker move_picker(context_.game.GetPosition(), best_move,
+                           /*skip_bad_captures=*/shared_.features.see_pruning);
+    while (const std::optional<Move> next_move = move_picker.Next()) {
+      const Move move = *next_move;
+      PrefetchChild(move);
+      {
+        ScopedSearchMove scoped_move(move, context_);
+        score = -QuiescentSearch(-beta, -alpha, ply + 1);
+      }
+      if (Stopped()) {
+        return 0;
+      }
 
       if (score >= beta) {
         return beta;
@@ -228,10 +503,42 @@ class AlphaBetaSearcher {
     return alpha;
   }
 
+  // Probes the shared transposition table for the current position and
+  // counts the probe in this thread's metrics.
+  [[nodiscard]] std::optional<int> ProbeTranspositions(
+      const TranspositionTable::ProbeParams& probe_params, Move* best_move) {
+    const std::optional<int> score = shared_.transpositions.Probe(
+        context_.game.GetPosition().GetKey(), probe_params, best_move);
+    if (score) {
+      context_.transposition_table_hits.RecordHit();
+    } else {
+      context_.transposition_table_hits.RecordMiss();
+    }
+    return score;
+  }
+
   [[nodiscard]] int GetScore() const {
-    const int score = Evaluate(context_.game.GetPosition(),
-                               CalculatePhase(context_.game.GetPosition()));
-    return context_.game.GetPosition().SideToMove() == kWhite ? score : -score;
+    const Position& position = context_.game.GetPosition();
+    const ZobristKey key = position.GetKey();
+
+    if (const std::optional<int> cached = context_.eval_cache.Probe(key)) {
+      return *cached;
+    }
+
+    int score = 0;
+    if (context_.network) {
+      score = nnue::Evaluate(*context_.network, position,
+                             context_.nnue_accumulators.back());
+    } else {
+      score = Evaluate(position, context_.accumulators.back(),
+                       context_.pawn_hash_table);
+      score = position.SideToMove() == kWhite ? score : -score;
+    }
+
+    // The key includes the side to move, so the cache holds scores relative
+    // to the side to move.
+    context_.eval_cache.Record(key, score);
+    return score;
   }
 
   [[nodiscard]] bool CurrentSideInCheck() const {
@@ -257,46 +564,287 @@ class AlphaBetaSearcher {
         && !CurrentSideInCheck();
   }
 
+  // Starts loading the transposition table bucket of the position after
+  // `move`, so that the memory access overlaps with making the move.
+  void PrefetchChild(const Move move) const {
+    if (shared_.features.prefetch) {
+      shared_.transpositions.Prefetch(
+          context_.game.GetPosition().GetKeyAfter(move));
+    }
+  }
+
+  // The main thread ignores the stop signal until its first iteration
+  // completes. That iteration is cheap, and a search must not end without a
+  // move to play.
+  [[nodiscard]] bool Stopped() const {
+    return (completed_iteration_ || !is_main_thread_) &&
+           shared_.stop.load(std::memory_order_relaxed);
+  }
+
+  void CountNode() {
+    // Only this thread writes to `nodes`, so a read-modify-write is not needed.
+    const std::int64_t nodes = context_.nodes.load(std::memory_order_relaxed);
+    context_.nodes.store(nodes + 1, std::memory_order_relaxed);
+
+    // Reading the clock is comparatively expensive, so the limits are only
+    // checked periodically.
+    constexpr std::int64_t kCheckLimitsInterval = 1024;
+    if (is_main_thread_ && (nodes + 1) % kCheckLimitsInterval == 0) {
+      CheckLimits();
+    }
+  }
+
+  // Stops the search once it runs out of time or nodes. The first iteration
+  // always runs to completion, so that there is a move to play.
+  void CheckLimits() {
+    if (!completed_iteration_ || Pondering()) {
+      return;
+    }
+
+    if (shared_.time_manager.MustStop(std::chrono::steady_clock::now()) ||
+        (shared_.max_nodes && CountAllNodes() >= *shared_.max_nodes)) {
+      shared_.stop.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns whether the search is still pondering, in which case no limits
+  // apply. Our clock only starts once the opponent plays the expected move, so
+  // the time manager is restarted when the ponder hit is first observed.
+  [[nodiscard]] bool Pondering() {
+    if (!pondering_ || shared_.pondering.load(std::memory_order_relaxed)) {
+      return pondering_;
+    }
+    pondering_ = false;
+    shared_.time_manager =
+        TimeManager(shared_.time_control, std::chrono::steady_clock::now());
+    return false;
+  }
+
+  [[nodiscard]] std::int64_t CountAllNodes() const {
+    std::int64_t nodes = 0;
+    for (const ThreadContext* thread : shared_.threads) {
+      nodes += thread->nodes.load(std::memory_order_relaxed);
+    }
+    return nodes;
+  }
+
+  // Sums the metrics of a per-thread table across all threads.
+  // `get_metrics` returns the metrics of a single thread's table.
+  template <typename GetMetrics>
+  [[nodiscard]] HitCounter::Metrics SumThreadMetrics(
+      GetMetrics get_metrics) const {
+    HitCounter::Metrics sum;
+    for (const ThreadContext* thread : shared_.threads) {
+      sum = sum + get_metrics(*thread);
+    }
+    return sum;
+  }
+
   [[nodiscard]] SearchInfo MakeSearchInfo(const int score,
                                           const int depth) const {
     const auto now = std::chrono::steady_clock::now();
-    const std::chrono::duration<double> elapsed = now - context_.start_time;
+    const std::chrono::duration<double> elapsed = now - shared_.start_time;
     const double elapsed_seconds = elapsed.count();
 
+    const std::int64_t nodes = CountAllNodes();
     return {
         .depth = depth,
         .score = score,
         .mate_in = GetMateIn(score),
-        .nodes = nodes_,
+        .nodes = nodes,
         .node_per_second = static_cast<std::int64_t>(
-            static_cast<double>(nodes_) / elapsed_seconds),
-        .transposition_table_metrics = context_.transpositions.GetMetrics(),
+            static_cast<double>(nodes) / elapsed_seconds),
+        .hash_full = shared_.transpositions.GetHashFull(),
+        .transposition_table_metrics =
+            SumThreadMetrics([](const ThreadContext& thread) {
+              return thread.transposition_table_hits.GetMetrics();
+            }),
+        .pawn_hash_table_metrics =
+            SumThreadMetrics([](const ThreadContext& thread) {
+              return thread.pawn_hash_table.GetMetrics();
+            }),
+        .eval_cache_metrics =
+            SumThreadMetrics([](const ThreadContext& thread) {
+              return thread.eval_cache.GetMetrics();
+            }),
         .principal_variation = std::format("{}", context_.pv_table),
     };
   }
 
-  SearchContext& context_;
-  std::int64_t nodes_;
+  SearchContext& shared_;
+  ThreadContext& context_;
+
+  const bool is_main_thread_;
+
+  // Whether the main thread has completed at least one iteration.
+  bool completed_iteration_ = false;
+
+  // Whether the main thread has yet to observe the end of pondering.
+  bool pondering_;
+
+  // The score of the last completed iteration, which centers the aspiration
+  // window of the next one.
+  std::optional<int> previous_score_;
 };
 
+// Runs iterative deepening on a helper thread until the main thread signals
+// completion. Odd-numbered helpers search one ply deeper than the main thread,
+// so that the threads diverge and fill the transposition table with entries
+// the main thread will need next.
+void RunHelper(SearchContext& shared, ThreadContext& context,
+               const int thread_index, const int max_depth) {
+  AlphaBetaSearcher searcher(shared, context);
+  const int depth_offset = thread_index % 2;
+  for (int depth = 1 + depth_offset; depth <= max_depth + depth_offset;
+       ++depth) {
+    if (shared.stop.load(std::memory_order_relaxed)) {
+      return;
+    }
+    searcher.SearchHelper(depth);
+  }
+}
+
 }  // namespace
 
-Move Search(const Game& game, SearchOptions options) {
-  SearchContext context = {
-      .game = game,
+Searcher::Searcher(const std::size_t hash_size_mb)
+    : transpositions_(hash_size_mb) {}
+
+Searcher::~Searcher() {
+  Stop();
+  Wait();
+}
+
+Move Searcher::Search(const Game& game, SearchOptions options) {
+  Stop();
+  Wait();
+  stop_.store(false, std::memory_order_relaxed);
+  pondering_.store(options.ponder, std::memory_order_relaxed);
+  return Run(game, std::move(options)).best_move;
+}
+
+void Searcher::StartSearch(
+    const Game& game, SearchOptions options,
+    std::function<void(const SearchResult&)> on_result) {
+  Stop();
+  Wait();
+
+  // The flags are reset before the thread starts, so that a Stop() or
+  // PonderHit() issued right after this returns is not lost.
+  stop_.store(false, std::memory_order_relaxed);
+  pondering_.store(options.ponder, std::memory_order_relaxed);
+  thread_ = std::jthread([this, game, options = std::move(options),
+                          on_result = std::move(on_result)]() mutable {
+    on_result(Run(game, std::move(options)));
+  });
+}
+
+void Searcher::Wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+SearchResult Searcher::Run(const Game& game, SearchOptions options) {
+  DCHECK_GE(options.threads, 1);
+  DCHECK_GE(options.depth, 1);
+  DCHECK_LE(options.depth, kMaxSearchDepth);
+  const int num_threads = std::max(options.threads, 1);
+  while (std::ssize(threads_) < num_threads) {
+    threads_.push_back(std::make_unique<ThreadContext>());
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  SearchContext shared = {
       .info_observer = std::move(options.info_observer),
-      .start_time = std::chrono::steady_clock::now(),
-      .pv_table = PrincipalVariationTable(),
-      .transpositions = TranspositionTable(),
+      .start_time = start_time,
+      .transpositions = transpositions_,
+      .features = options.features,
+      .time_control = options.time_control,
+      .time_manager = TimeManager(options.time_control, start_time),
+      .max_nodes = options.nodes,
+      .stop = stop_,
+      .pondering = pondering_,
   };
+  shared.transpositions.NewSearch();
+  for (int i = 0; i < num_threads; ++i) {
+    threads_[i]->Reset(game, options);
+    shared.threads.push_back(threads_[i].get());
+  }
+
+  std::vector<std::jthread> helpers;
+  for (int i = 1; i < std::ssize(shared.threads); ++i) {
+    helpers.emplace_back(RunHelper, std::ref(shared),
+                         std::ref(*shared.threads[i]), i, options.depth);
+  }
 
-  AlphaBetaSearcher searcher(context);
-  Move best_move = Move::NullMove();
+  AlphaBetaSearcher searcher(shared, *shared.threads[0]);
+  SearchResult result;
   for (int depth = 1; depth <= options.depth; ++depth) {
-    best_move = searcher.Search(depth);
+    const std::optional<SearchResult> iteration_result = searcher.Search(depth);
+    if (!iteration_result) {
+      break;
+    }
+    result = *iteration_result;
+
+    if (!searcher.CanStartIteration()) {
+      break;
+    }
   }
 
-  return best_move;
+  // UCI forbids sending the best move of an infinite or pondering search
+  // before the GUI asks for it, even if the depth limit was reached.
+  {
+    std::unique_lock lock(mutex_);
+    stop_or_ponder_hit_.wait(lock, [this, &options] {
+      return stop_.load(std::memory_order_relaxed) ||
+             (!options.infinite && !pondering_.load(std::memory_order_relaxed));
+    });
+  }
+
+  shared.stop.store(true, std::memory_order_relaxed);
+  helpers.clear();
+
+  return result;
+}
+
+void Searcher::Stop() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_.store(true, std::memory_order_relaxed);
+  }
+  stop_or_ponder_hit_.notify_all();
+}
+
+void Searcher::PonderHit() {
+  {
+    std::lock_guard lock(mutex_);
+    pondering_.store(false, std::memory_order_relaxed);
+  }
+  stop_or_ponder_hit_.notify_all();
+}
+
+void Searcher::ResizeHash(const std::size_t size_mb, const int threads) {
+  Stop();
+  Wait();
+  transpositions_.Resize(size_mb, threads);
+}
+
+void Searcher::ClearHash(const int threads) {
+  Stop();
+  Wait();
+  transpositions_.Clear(threads);
+}
+
+void Searcher::Clear(const int threads) {
+  Stop();
+  Wait();
+  transpositions_.Clear(threads);
+  threads_.clear();
+}
+
+Move Search(const Game& game, SearchOptions options) {
+  Searcher searcher;
+  return searcher.Search(game, std::move(options));
 }
 
 }  // namespace follychess
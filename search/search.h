@@ -18,11 +18,26 @@
 #ifndef FOLLYCHESS_SEARCH_SEARCH_H_
 #define FOLLYCHESS_SEARCH_SEARCH_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
 #include "engine/game.h"
 #include "engine/move.h"
 #include "engine/position.h"
+#include "search/eval_cache.h"
 #include "search/evaluation.h"
+#include "search/hit_counter.h"
+#include "search/nnue.h"
 #include "search/principal_variation.h"
+#include "search/time_manager.h"
 #include "transposition.h"
 
 namespace follychess {
@@ -44,9 +59,21 @@ struct SearchInfo {
   //
   std::optional<int> mate_in;
 
+  // The number of nodes visited, summed across all search threads.
   std::int64_t nodes;
   std::int64_t node_per_second;
-  TranspositionTable::Metrics transposition_table_metrics;
+
+  // The permille of the transposition table written by this search, as
+  // reported by UCI's `hashfull`.
+  int hash_full;
+
+  // Summed across all search threads. Each thread counts its own probes of
+  // the shared transposition table, and owns its own pawn hash table and
+  // evaluation cache.
+  HitCounter::Metrics transposition_table_metrics;
+  PawnHashTable::Metrics pawn_hash_table_metrics;
+  EvalCache::Metrics eval_cache_metrics;
+
   std::string principal_variation;
 };
 
@@ -63,17 +90,56 @@ struct std::formatter<follychess::SearchInfo> : std::formatter<std::string> {
 
     auto out = context.out();
     return std::format_to(out,
-                          "info depth {} score {} nodes {} nps {} tthits {} "
-                          "tthitrate {:.2f} pv {}",
+                          "info depth {} score {} nodes {} nps {} hashfull {} "
+                          "tthits {} tthitrate {:.2f} pawnhits {} "
+                          "pawnhitrate {:.2f} evalhits {} evalhitrate {:.2f} "
+                          "pv {}",
                           info.depth, score, info.nodes, info.node_per_second,
+                          info.hash_full,
                           info.transposition_table_metrics.hits,
                           info.transposition_table_metrics.hit_rate,
+                          info.pawn_hash_table_metrics.hits,
+                          info.pawn_hash_table_metrics.hit_rate,
+                          info.eval_cache_metrics.hits,
+                          info.eval_cache_metrics.hit_rate,
                           info.principal_variation);
   }
 };
 
 namespace follychess {
 
+// The deepest iteration the search will run.
+constexpr int kMaxSearchDepth = 64;
+
+// The techniques that make the search visit fewer nodes or spend less time on
+// each. All are on by default. They can be turned off one at a time so that
+// benchmarks/search_benchmark.cc can measure what each one saves.
+struct SearchFeatures {
+  // Prefetches the transposition table entry of each child before making the
+  // move.
+  bool prefetch = true;
+
+  // Starts each iteration with a narrow window around the score of the
+  // previous iteration, widening it whenever the search fails outside of it.
+  bool aspiration_windows = true;
+
+  // Searches every move but the first with a null window, and only searches it
+  // again with the full window if it beats the best move so far.
+  bool principal_variation_search = true;
+
+  // Searches late quiet moves to a reduced depth, and only searches them again
+  // to the full depth if they beat alpha.
+  bool late_move_reductions = true;
+
+  // Skips the remaining quiet moves of shallow nodes once enough moves were
+  // searched.
+  bool late_move_pruning = true;
+
+  // Skips the captures that lose material according to the static exchange
+  // evaluation in the quiescent search.
+  bool see_pruning = true;
+};
+
 struct SearchOptions {
   SearchOptions& SetDepth(int value) {
     depth = value;
@@ -82,6 +148,79 @@ struct SearchOptions {
 
   int depth = 5;
 
+  // The number of threads to search with. All threads share a single
+  // transposition table. Helper threads search the same position with varying
+  // depths in order to populate the table ahead of the main thread (i.e., Lazy
+  // SMP).
+  SearchOptions& SetThreads(int value) {
+    threads = value;
+    return *this;
+  }
+
+  int threads = 1;
+
+  // The techniques that speed up the search. See SearchFeatures.
+  SearchOptions& SetFeatures(const SearchFeatures& value) {
+    features = value;
+    return *this;
+  }
+
+  SearchFeatures features;
+
+  // The memory limit of each search thread's evaluation cache. Zero disables
+  // the cache.
+  SearchOptions& SetEvalCacheSize(std::size_t size_mb) {
+    eval_cache_size_mb = size_mb;
+    return *this;
+  }
+
+  std::size_t eval_cache_size_mb = 1;
+
+  // The network to evaluate positions with. If not set, the handcrafted
+  // evaluation is used.
+  SearchOptions& SetNetwork(std::shared_ptr<const nnue::Network> value) {
+    network = std::move(value);
+    return *this;
+  }
+
+  std::shared_ptr<const nnue::Network> network;
+
+  // Limits the search by the clock. By default, the search is only limited by
+  // its depth.
+  SearchOptions& SetTimeControl(const TimeControl& value) {
+    time_control = value;
+    return *this;
+  }
+
+  TimeControl time_control;
+
+  // Stops the search after visiting about this many nodes.
+  SearchOptions& SetNodes(std::int64_t value) {
+    nodes = value;
+    return *this;
+  }
+
+  std::optional<std::int64_t> nodes;
+
+  // Searches until Searcher::Stop() is called. The best move is held back
+  // even if the depth limit is reached first.
+  SearchOptions& SetInfinite(bool value) {
+    infinite = value;
+    return *this;
+  }
+
+  bool infinite = false;
+
+  // Searches the position during the opponent's time. The limits only apply
+  // after Searcher::PonderHit() is called. Until then, the search behaves as
+  // if it were infinite.
+  SearchOptions& SetPonder(bool value) {
+    ponder = value;
+    return *this;
+  }
+
+  bool ponder = false;
+
   SearchOptions& SetInfoObserver(std::function<void(const SearchInfo&)> value) {
     info_observer = std::move(value);
     return *this;
@@ -91,6 +230,88 @@ struct SearchOptions {
   };
 };
 
+struct SearchResult {
+  Move best_move = Move::NullMove();
+
+  // The expected reply to the best move, which is worth pondering on. This is
+  // the null move if the principal variation ends at the best move.
+  Move ponder_move = Move::NullMove();
+};
+
+struct ThreadContext;
+
+// A long-lived search engine. The transposition table and the per-thread move
+// ordering heuristics are kept between searches, so that each move of a game
+// builds on the work done for the previous ones.
+class Searcher {
+ public:
+  explicit Searcher(std::size_t hash_size_mb = 256);
+
+  Searcher(const Searcher&) = delete;
+  Searcher& operator=(const Searcher&) = delete;
+
+  ~Searcher();
+
+  // Runs iterative deepening until the depth limit is reached, the time or
+  // nodes run out, or Stop() is called. Returns the best move of the last
+  // completed iteration.
+  Move Search(const Game& game, SearchOptions options = SearchOptions());
+
+  // Runs Search() on a background thread and returns immediately.
+  // `on_result` is called on that thread once the search ends. A search that
+  // is already running is stopped first.
+  void StartSearch(const Game& game, SearchOptions options,
+                   std::function<void(const SearchResult&)> on_result);
+
+  // Blocks until the background search, if any, has ended.
+  void Wait();
+
+  // Aborts the running search. The first iteration still completes, so that
+  // the search returns a move. This can be called from any thread.
+  void Stop();
+
+  // Ends the pondering phase of the running search, i.e., the opponent played
+  // the expected move. The time limits start counting from now. This can be
+  // called from any thread.
+  void PonderHit();
+
+  // Reallocates the transposition table. All entries are lost. A running
+  // search is stopped first.
+  void ResizeHash(std::size_t size_mb, int threads = 1);
+
+  // Removes all entries from the transposition table. A running search is
+  // stopped first.
+  void ClearHash(int threads = 1);
+
+  // Forgets everything learned in earlier searches, e.g., when a new game
+  // starts. A running search is stopped first.
+  void Clear(int threads = 1);
+
+  [[nodiscard]] const TranspositionTable& GetTranspositionTable() const {
+    return transpositions_;
+  }
+
+ private:
+  // Runs the search. The caller must have reset `stop_` and `pondering_`.
+  SearchResult Run(const Game& game, SearchOptions options);
+
+  TranspositionTable transpositions_;
+  std::vector<std::unique_ptr<ThreadContext>> threads_;
+  std::atomic<bool> stop_ = false;
+  std::atomic<bool> pondering_ = false;
+
+  // Notified by Stop() and PonderHit(), which update the flags above while
+  // holding `mutex_`. An infinite or pondering search that reached its depth
+  // limit waits on this before returning its result.
+  std::mutex mutex_;
+  std::condition_variable stop_or_ponder_hit_;
+
+  // Runs the search started by StartSearch().
+  std::jthread thread_;
+};
+
+// Searches the game with a fresh searcher. Nothing is kept once the search
+// completes.
 Move Search(const Game& game, SearchOptions options = SearchOptions());
 
 }  // namespace follychess
@@ -20,6 +20,13 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
 #include "engine/move.h"
 #include "engine/move_generator.h"
 #include "engine/position.h"
@@ -29,9 +36,16 @@
 namespace follychess {
 namespace {
 
+using ::testing::Contains;
 using ::testing::ElementsAreArray;
 using ::testing::Eq;
+using ::testing::Gt;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::Lt;
+using ::testing::Ne;
+using ::testing::Not;
 using ::testing::Optional;
 
 constexpr int kMaxMovesAllowed = 16;
@@ -196,5 +210,268 @@ TEST(Search, BlackMateInOne) {
   EXPECT_THAT(info.mate_in, Optional(1));
 }
 
+TEST(Search, MultipleThreads) {
+  Game game(
+      MakePosition("8: r . b q k . n r"
+                   "7: p p p p . p p p"
+                   "6: . . n . . . . ."
+                   "5: . . b . p . . ."
+                   "4: . . B . P . . ."
+                   "3: . . . . . Q . ."
+                   "2: P P P P . P P P"
+                   "1: R N B . K . N R"
+                   "   a b c d e f g h"
+                   //
+                   "w KQkq - 4 4"));
+
+  std::vector<SearchInfo> infos;
+  const Move move = Search(
+      game,
+      SearchOptions()
+          .SetInfoObserver(
+              [&infos](const SearchInfo& curr) { infos.push_back(curr); })
+          .SetDepth(4)
+          .SetThreads(4));
+  EXPECT_THAT(move, Eq(MakeMove("f3f7#c")));
+  ASSERT_THAT(infos, testing::SizeIs(4));
+  EXPECT_THAT(infos.back().mate_in, Optional(1));
+
+  // Each thread counts its own probes of the shared table.
+  const HitCounter::Metrics& metrics = infos.back().transposition_table_metrics;
+  EXPECT_THAT(metrics.hits, Gt(0));
+  EXPECT_THAT(metrics.misses, Gt(0));
+}
+
+TEST(Searcher, ReusesTranspositionTableAcrossSearches) {
+  Game game(
+      MakePosition("8: r . b q k . n r"
+                   "7: p p p p . p p p"
+                   "6: . . n . . . . ."
+                   "5: . . b . p . . ."
+                   "4: . . B . P . . ."
+                   "3: . . . . . Q . ."
+                   "2: P P P P . P P P"
+                   "1: R N B . K . N R"
+                   "   a b c d e f g h"
+                   //
+                   "w KQkq - 4 4"));
+
+  Searcher searcher(/*hash_size_mb=*/1);
+  std::vector<SearchInfo> infos;
+  const auto search = [&] {
+    infos.clear();
+    const Move move = searcher.Search(
+        game, SearchOptions()
+                  .SetInfoObserver([&infos](const SearchInfo& curr) {
+                    infos.push_back(curr);
+                  })
+                  .SetDepth(4));
+    EXPECT_THAT(move, Eq(MakeMove("f3f7#c")));
+    EXPECT_THAT(infos, testing::SizeIs(4));
+    return infos.back().nodes;
+  };
+
+  const std::int64_t cold_nodes = search();
+
+  // The root never cuts off on the table, but the moves stored by the first
+  // search order the second one.
+  EXPECT_THAT(search(), Lt(cold_nodes));
+  EXPECT_THAT(infos.front().transposition_table_metrics.hits, Gt(0));
+
+  searcher.Clear();
+  EXPECT_THAT(search(), Eq(cold_nodes));
+}
+
+TEST(Searcher, WindowsFindTheSameMate) {
+  // Aspiration windows around a mate score must be clamped to the bounds of
+  // the full window.
+  const Game game(
+      MakePosition("8: . . . . . . k ."
+                   "7: . . . . . p p p"
+                   "6: . . . . . . . ."
+                   "5: . . . . . . . ."
+                   "4: . . . . . . . ."
+                   "3: . . . . . . . ."
+                   "2: . . . . . . . ."
+                   "1: R . . . . . K ."
+                   "   a b c d e f g h"
+                   //
+                   "w - - 0 1"));
+
+  for (const bool windows : {true, false}) {
+    Searcher searcher(/*hash_size_mb=*/16);
+    SearchInfo info;
+    const Move move = searcher.Search(
+        game, SearchOptions()
+                  .SetInfoObserver(
+                      [&info](const SearchInfo& curr) { info = curr; })
+                  .SetDepth(6)
+                  .SetFeatures({
+                      .aspiration_windows = windows,
+                      .principal_variation_search = windows,
+                  }));
+
+    EXPECT_THAT(move, Eq(MakeMove("a1a8")));
+    EXPECT_THAT(info.mate_in, Optional(1));
+  }
+}
+
+TEST(Searcher, WidenedWindowsFindTheSameScore) {
+  // The score drops from 93 to 30 at depth 4 and rises to 91 at depth 5, so
+  // both iterations fail outside their initial window and are searched again.
+  // The techniques that depend on the window are turned off, since they may
+  // legitimately change the score.
+  const Game game(
+      MakePosition("8: r . . . k . . r"
+                   "7: p p p b b p p p"
+                   "6: . . n . . q . P"
+                   "5: . P . . p . . ."
+                   "4: . . . p n . . ."
+                   "3: B N . . P N P ."
+                   "2: P . P P Q P B ."
+                   "1: R . . . K . . R"
+                   "   a b c d e f g h"
+                   //
+                   "b KQkq - 0 1"));
+
+  std::vector<Move> moves;
+  std::vector<std::vector<int>> scores;
+  for (const bool windows : {true, false}) {
+    Searcher searcher(/*hash_size_mb=*/16);
+    std::vector<int>& curr_scores = scores.emplace_back();
+    moves.push_back(searcher.Search(
+        game, SearchOptions()
+                  .SetInfoObserver([&curr_scores](const SearchInfo& curr) {
+                    curr_scores.push_back(curr.score);
+                  })
+                  .SetDepth(5)
+                  .SetFeatures({
+                      .aspiration_windows = windows,
+                      .principal_variation_search = false,
+                      .late_move_reductions = false,
+                      .late_move_pruning = false,
+                  })));
+  }
+
+  EXPECT_THAT(scores[0], ElementsAreArray({221, 221, 93, 30, 91}));
+  EXPECT_THAT(moves[0], Eq(MakeMove("e7a3#c")));
+  EXPECT_THAT(moves[1], Eq(moves[0]));
+  EXPECT_THAT(scores[1].back(), Eq(scores[0].back()));
+}
+
+TEST(Searcher, MoveTime) {
+  Searcher searcher(/*hash_size_mb=*/16);
+  Game game;
+
+  const auto start = std::chrono::steady_clock::now();
+  const Move move = searcher.Search(
+      game, SearchOptions().SetDepth(kMaxSearchDepth).SetTimeControl({
+                .move_time = std::chrono::milliseconds(100),
+            }));
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_THAT(GenerateLegalMoves(game.GetPosition()), Contains(move));
+  EXPECT_THAT(elapsed, Lt(std::chrono::seconds(1)));
+}
+
+TEST(Searcher, Nodes) {
+  Searcher searcher(/*hash_size_mb=*/16);
+  Game game;
+
+  std::vector<SearchInfo> infos;
+  const Move move = searcher.Search(
+      game, SearchOptions()
+                .SetInfoObserver(
+                    [&infos](const SearchInfo& curr) { infos.push_back(curr); })
+                .SetDepth(kMaxSearchDepth)
+                .SetNodes(20'000));
+
+  EXPECT_THAT(GenerateLegalMoves(game.GetPosition()), Contains(move));
+  ASSERT_THAT(infos, Not(IsEmpty()));
+  EXPECT_THAT(infos.back().nodes, Le(20'000));
+  EXPECT_THAT(infos.back().depth, Lt(kMaxSearchDepth));
+}
+
+TEST(Searcher, Stop) {
+  Searcher searcher(/*hash_size_mb=*/16);
+  Game game;
+
+  std::jthread stopper([&searcher] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    searcher.Stop();
+  });
+  const Move move =
+      searcher.Search(game, SearchOptions().SetDepth(kMaxSearchDepth));
+
+  EXPECT_THAT(GenerateLegalMoves(game.GetPosition()), Contains(move));
+}
+
+TEST(Searcher, StartSearch) {
+  Searcher searcher(/*hash_size_mb=*/16);
+  Game game;
+
+  std::optional<SearchResult> result;
+  searcher.StartSearch(game, SearchOptions().SetDepth(4),
+                       [&result](const SearchResult& curr) { result = curr; });
+  searcher.Wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_THAT(GenerateLegalMoves(game.GetPosition()),
+              Contains(result->best_move));
+  EXPECT_THAT(result->ponder_move, Ne(Move::NullMove()));
+}
+
+TEST(Searcher, StopDuringFirstIteration) {
+  Searcher searcher(/*hash_size_mb=*/16);
+  Game game;
+
+  std::optional<SearchResult> result;
+  searcher.StartSearch(game, SearchOptions().SetDepth(kMaxSearchDepth),
+                       [&result](const SearchResult& curr) { result = curr; });
+  searcher.Stop();
+  searcher.Wait();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_THAT(GenerateLegalMoves(game.GetPosition()),
+              Contains(result->best_move));
+}
+
+TEST(Searcher, InfiniteSearchWaitsForStop) {
+  Searcher searcher(/*hash_size_mb=*/16);
+  Game game;
+
+  std::atomic<bool> done = false;
+  searcher.StartSearch(game, SearchOptions().SetDepth(1).SetInfinite(true),
+                       [&done](const SearchResult&) { done = true; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(done);
+
+  searcher.Stop();
+  searcher.Wait();
+  EXPECT_TRUE(done);
+}
+
+TEST(Searcher, PonderHit) {
+  Searcher searcher(/*hash_size_mb=*/16);
+  Game game;
+
+  std::atomic<bool> done = false;
+  searcher.StartSearch(game,
+                       SearchOptions()
+                           .SetDepth(kMaxSearchDepth)
+                           .SetPonder(true)
+                           .SetTimeControl({
+                               .move_time = std::chrono::milliseconds(10),
+                           }),
+                       [&done](const SearchResult&) { done = true; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(done);
+
+  // The search ends on its own once the time limit applies.
+  searcher.PonderHit();
+  searcher.Wait();
+  EXPECT_TRUE(done);
+}
+
 }  // namespace
-}  // namespace follychess
\ No newline at end of file
+}  // namespace follychess
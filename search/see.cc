@@ -0,0 +1,108 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/see.h"
+
+#include <algorithm>
+#include <array>
+
+#include "engine/bitboard.h"
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess {
+namespace {
+
+// Returns the least valuable piece among `attackers`, or `kEmptyPiece` if
+// there is none. `square` is set to the square of that piece.
+[[nodiscard]] Piece GetLeastValuableAttacker(const Position& position,
+                                             const Bitboard attackers,
+                                             Square& square) {
+  for (int piece = kPawn; piece < kNumPieces; ++piece) {
+    const Bitboard pieces =
+        attackers & position.GetPieces(static_cast<Piece>(piece));
+    if (pieces) {
+      square = pieces.LeastSignificantBit();
+      return static_cast<Piece>(piece);
+    }
+  }
+  return kEmptyPiece;
+}
+
+}  // namespace
+
+int StaticExchangeEvaluation(const Position& position, const Move move) {
+  const Square to = move.GetTo();
+  const Piece attacker = position.GetPiece(move.GetFrom());
+  DCHECK_NE(attacker, kEmptyPiece);
+
+  Bitboard occupied = position.GetPieces() ^ Bitboard(move.GetFrom());
+  Piece victim = position.GetPiece(to);
+  if (move.IsEnPassantCapture()) {
+    victim = kPawn;
+    occupied ^= Bitboard(move.GetEnPassantVictim());
+  }
+
+  // `gains[i]` is the material won by the side making the i-th capture,
+  // assuming the exchange stops right after it.
+  std::array<int, 32> gains;
+  int depth = 0;
+  gains[0] = victim == kEmptyPiece ? 0 : kSeeValues[victim];
+
+  Piece on_square = attacker;
+  if (move.IsPromotion()) {
+    on_square = move.GetPromotedPiece();
+    gains[0] += kSeeValues[on_square] - kSeeValues[kPawn];
+  }
+
+  Side side = ~position.SideToMove();
+  while (depth + 1 < std::ssize(gains)) {
+    // Recomputing the attackers with the updated occupancy reveals the
+    // sliders behind the pieces that already captured.
+    const Bitboard attackers = position.GetAttackers(to, side, occupied) &
+                               occupied;
+    Square from = to;
+    const Piece next = GetLeastValuableAttacker(position, attackers, from);
+    if (next == kEmptyPiece) {
+      break;
+    }
+
+    if (next == kKing) {
+      // The king may only capture if the square is no longer defended.
+      const Bitboard without_king = occupied ^ Bitboard(from);
+      if (position.GetAttackers(to, ~side, without_king) & without_king) {
+        break;
+      }
+    }
+
+    ++depth;
+    gains[depth] = kSeeValues[on_square] - gains[depth - 1];
+    occupied ^= Bitboard(from);
+    on_square = next;
+    side = ~side;
+  }
+
+  // Each side only recaptures if that does not lose material.
+  while (depth > 0) {
+    gains[depth - 1] = -std::max(-gains[depth - 1], gains[depth]);
+    --depth;
+  }
+  return gains[0];
+}
+
+}  // namespace follychess
@@ -0,0 +1,51 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_SEE_H_
+#define FOLLYCHESS_SEARCH_SEE_H_
+
+#include <array>
+
+#include "engine/move.h"
+#include "engine/position.h"
+#include "engine/types.h"
+
+namespace follychess {
+
+// The piece values used by the static exchange evaluation. The king is never
+// captured, so its value does not matter.
+constexpr std::array<int, kNumPieces> kSeeValues = {100, 300, 300,
+                                                   500, 900, 0};
+
+// Returns the material balance for the side to move after `move` and the
+// best sequence of recaptures on its target square, where each side may stop
+// recapturing whenever that is better for it. Pieces are taken from the least
+// valuable attacker up, and sliders behind a piece that recaptures join the
+// exchange (i.e., x-rays). Pins and checks are ignored.
+[[nodiscard]] int StaticExchangeEvaluation(const Position& position,
+                                           Move move);
+
+// Returns whether `move` wins material or trades evenly according to the
+// static exchange evaluation.
+[[nodiscard]] inline bool IsGoodCapture(const Position& position,
+                                        const Move move) {
+  return StaticExchangeEvaluation(position, move) >= 0;
+}
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_SEE_H_
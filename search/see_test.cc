@@ -0,0 +1,166 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/see.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "engine/position.h"
+#include "engine/testing.h"
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
+TEST(StaticExchangeEvaluation, UndefendedPiece) {
+  const Position position = MakePosition(
+      "8: . k . r . . . ."
+      "7: . p p . . . . p"
+      "6: p . . . . . . ."
+      "5: . . . . p . . ."
+      "4: . . . . . . . ."
+      "3: P . . . . . P ."
+      "2: . P P . . . . P"
+      "1: . . K . R . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(StaticExchangeEvaluation(position, MakeMove("e1e5#c")),
+              Eq(100));
+  EXPECT_THAT(IsGoodCapture(position, MakeMove("e1e5#c")), IsTrue());
+}
+
+TEST(StaticExchangeEvaluation, XRays) {
+  // NxP, NxN, RxN, BxR, QxB and QxQ, where both queens only join the exchange
+  // once the pieces in front of them captured.
+  const Position position = MakePosition(
+      "8: . k . r . . . q"
+      "7: . p p n . . . p"
+      "6: p . . . . b . ."
+      "5: . . . . p . . ."
+      "4: . . . . . . . ."
+      "3: P . . N . . P ."
+      "2: . P P . R . B P"
+      "1: . . K . Q . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(StaticExchangeEvaluation(position, MakeMove("d3e5#c")),
+              Eq(-200));
+  EXPECT_THAT(IsGoodCapture(position, MakeMove("d3e5#c")), IsFalse());
+}
+
+TEST(StaticExchangeEvaluation, PieceDefendedByPawn) {
+  const Position position = MakePosition(
+      "8: k . . . . . . ."
+      "7: . . . . . . . ."
+      "6: . . p . . . . ."
+      "5: . . . p . . . Q"
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: K . . . . . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(StaticExchangeEvaluation(position, MakeMove("h5d5#c")),
+              Eq(-800));
+}
+
+TEST(StaticExchangeEvaluation, EvenTrade) {
+  const Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . . . . ."
+      "6: . . . . p . . ."
+      "5: . . . n . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . B"
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(StaticExchangeEvaluation(position, MakeMove("h1d5#c")), Eq(0));
+  EXPECT_THAT(IsGoodCapture(position, MakeMove("h1d5#c")), IsTrue());
+}
+
+TEST(StaticExchangeEvaluation, EnPassant) {
+  const Position position = MakePosition(
+      "8: . . . . k . . ."
+      "7: . . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . p P . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - d6 0 1");
+
+  EXPECT_THAT(StaticExchangeEvaluation(position, MakeMove("e5d6#ep")),
+              Eq(100));
+}
+
+TEST(StaticExchangeEvaluation, Promotion) {
+  const Position position = MakePosition(
+      "8: . r . . k . . ."
+      "7: P . . . . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . . . . . ."
+      "1: . . . . K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(StaticExchangeEvaluation(position, MakeMove("a7b8q#c")),
+              Eq(1300));
+}
+
+TEST(StaticExchangeEvaluation, KingDoesNotCaptureDefendedPiece) {
+  // After RxN and RxR, the king cannot recapture since the second rook
+  // defends the square.
+  const Position position = MakePosition(
+      "8: . . . r k . . ."
+      "7: . . . r . . . ."
+      "6: . . . . . . . ."
+      "5: . . . . . . . ."
+      "4: . . . . . . . ."
+      "3: . . . . . . . ."
+      "2: . . . n . . . ."
+      "1: . . . R K . . ."
+      "   a b c d e f g h"
+      //
+      "   w - - 0 1");
+
+  EXPECT_THAT(StaticExchangeEvaluation(position, MakeMove("d1d2#c")),
+              Eq(-200));
+}
+
+}  // namespace
+}  // namespace follychess
@@ -0,0 +1,73 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include "search/time_manager.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace follychess {
+namespace {
+
+using std::chrono::milliseconds;
+
+// Reserved for the latency between the engine and the GUI, so that the
+// engine does not lose on time when it uses its full allocation.
+constexpr milliseconds kMoveOverhead(10);
+
+// The number of moves the remaining time is spread across in sudden death.
+constexpr int kDefaultMovesToGo = 30;
+
+// The hard limit allows an iteration to run this many times longer than the
+// soft limit, as long as it stays within kMaxTimeFraction of the clock.
+constexpr int kHardLimitMultiplier = 4;
+constexpr double kMaxTimeFraction = 0.75;
+
+}  // namespace
+
+TimeManager::TimeManager(const TimeControl& time_control,
+                         const Clock::time_point start_time)
+    : start_time_(start_time) {
+  if (time_control.move_time) {
+    const milliseconds limit =
+        std::max(*time_control.move_time - kMoveOverhead, milliseconds(1));
+    soft_limit_ = limit;
+    hard_limit_ = limit;
+    return;
+  }
+
+  if (!time_control.time_left) {
+    return;
+  }
+
+  const milliseconds available =
+      std::max(*time_control.time_left - kMoveOverhead, milliseconds(1));
+  const int moves_to_go =
+      std::max(time_control.moves_to_go.value_or(kDefaultMovesToGo), 1);
+
+  const milliseconds hard_limit = std::max(
+      std::chrono::duration_cast<milliseconds>(available * kMaxTimeFraction),
+      milliseconds(1));
+  const milliseconds soft_limit =
+      available / moves_to_go + time_control.increment * 3 / 4;
+
+  hard_limit_ = std::clamp(soft_limit * kHardLimitMultiplier, milliseconds(1),
+                          hard_limit);
+  soft_limit_ = std::min(soft_limit, *hard_limit_);
+}
+
+}  // namespace follychess
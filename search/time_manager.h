@@ -0,0 +1,86 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FOLLYCHESS_SEARCH_TIME_MANAGER_H_
+#define FOLLYCHESS_SEARCH_TIME_MANAGER_H_
+
+#include <chrono>
+#include <optional>
+
+namespace follychess {
+
+// The clock parameters of a UCI `go` command, from the perspective of the side
+// to move.
+struct TimeControl {
+  // The time left on the clock (i.e., `wtime` or `btime`).
+  std::optional<std::chrono::milliseconds> time_left;
+
+  // The increment per move (i.e., `winc` or `binc`).
+  std::chrono::milliseconds increment{0};
+
+  // The number of moves until the next time control (i.e., `movestogo`). If
+  // unset, the game is played in sudden death.
+  std::optional<int> moves_to_go;
+
+  // The exact time to search for (i.e., `movetime`). Takes precedence over the
+  // other parameters.
+  std::optional<std::chrono::milliseconds> move_time;
+};
+
+// Turns a time control into deadlines for a single search:
+//
+//   * The soft deadline is checked between iterations of iterative deepening.
+//     Once it passes, no new iteration is started, since it would most likely
+//     not finish in time.
+//
+//   * The hard deadline is checked while searching. Once it passes, the search
+//     is aborted and the best move of the last completed iteration is played.
+//
+class TimeManager {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // A time manager without deadlines.
+  TimeManager() = default;
+
+  TimeManager(const TimeControl& time_control, Clock::time_point start_time);
+
+  [[nodiscard]] bool CanStartIteration(Clock::time_point now) const {
+    return !soft_limit_ || now - start_time_ < *soft_limit_;
+  }
+
+  [[nodiscard]] bool MustStop(Clock::time_point now) const {
+    return hard_limit_ && now - start_time_ >= *hard_limit_;
+  }
+
+  [[nodiscard]] std::optional<std::chrono::milliseconds> GetSoftLimit() const {
+    return soft_limit_;
+  }
+
+  [[nodiscard]] std::optional<std::chrono::milliseconds> GetHardLimit() const {
+    return hard_limit_;
+  }
+
+ private:
+  Clock::time_point start_time_;
+  std::optional<std::chrono::milliseconds> soft_limit_;
+  std::optional<std::chrono::milliseconds> hard_limit_;
+};
+
+}  // namespace follychess
+
+#endif  // FOLLYCHESS_SEARCH_TIME_MANAGER_H_
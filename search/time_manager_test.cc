@@ -0,0 +1,103 @@
+// FollyChess is a UCI-compatible chess engine written in C++23.
+//
+// Copyright (C) 2025-2026 Aryan Naraghi <aryan.naraghi@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "search/time_manager.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace follychess {
+namespace {
+
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Optional;
+using std::chrono::milliseconds;
+
+constexpr TimeManager::Clock::time_point kStart;
+
+TEST(TimeManager, NoLimits) {
+  TimeManager time_manager(TimeControl(), kStart);
+
+  EXPECT_THAT(time_manager.GetSoftLimit(), Eq(std::nullopt));
+  EXPECT_THAT(time_manager.GetHardLimit(), Eq(std::nullopt));
+  EXPECT_THAT(time_manager.CanStartIteration(kStart + std::chrono::hours(1)),
+              IsTrue());
+  EXPECT_THAT(time_manager.MustStop(kStart + std::chrono::hours(1)),
+              IsFalse());
+}
+
+TEST(TimeManager, MoveTime) {
+  TimeManager time_manager(
+      {
+          .time_left = milliseconds(60'000),
+          .move_time = milliseconds(1'000),
+      },
+      kStart);
+
+  EXPECT_THAT(time_manager.GetSoftLimit(), Optional(milliseconds(990)));
+  EXPECT_THAT(time_manager.GetHardLimit(), Optional(milliseconds(990)));
+}
+
+TEST(TimeManager, SuddenDeath) {
+  TimeManager time_manager({.time_left = milliseconds(60'000)}, kStart);
+
+  EXPECT_THAT(time_manager.GetSoftLimit(), Optional(milliseconds(1'999)));
+  EXPECT_THAT(time_manager.GetHardLimit(), Optional(milliseconds(7'996)));
+}
+
+TEST(TimeManager, Increment) {
+  TimeManager time_manager(
+      {
+          .time_left = milliseconds(10'000),
+          .increment = milliseconds(1'000),
+      },
+      kStart);
+
+  EXPECT_THAT(time_manager.GetSoftLimit(), Optional(milliseconds(1'083)));
+  EXPECT_THAT(time_manager.GetHardLimit(), Optional(milliseconds(4'332)));
+}
+
+TEST(TimeManager, LastMoveBeforeTimeControl) {
+  TimeManager time_manager(
+      {
+          .time_left = milliseconds(1'000),
+          .moves_to_go = 1,
+      },
+      kStart);
+
+  // Never spend more than a fraction of the clock on a single move.
+  EXPECT_THAT(time_manager.GetSoftLimit(), Optional(milliseconds(742)));
+  EXPECT_THAT(time_manager.GetHardLimit(), Optional(milliseconds(742)));
+}
+
+TEST(TimeManager, AlmostNoTimeLeft) {
+  TimeManager time_manager({.time_left = milliseconds(5)}, kStart);
+
+  EXPECT_THAT(time_manager.GetHardLimit(), Optional(milliseconds(1)));
+  EXPECT_THAT(time_manager.MustStop(kStart + milliseconds(1)), IsTrue());
+}
+
+TEST(TimeManager, Deadlines) {
+  TimeManager time_manager({.time_left = milliseconds(60'000)}, kStart);
+
+  EXPECT_THAT(time_manager.CanStartIteration(kStart + milliseconds(1'998)),
+              IsTrue());
+  EXPECT_THAT(time_manager.CanStartIteration(kStart + milliseconds(1'999)),
+              IsFalse());
+
+  EXPECT_THAT(time_manager.MustStop(kStart + milliseconds(7'995)), IsFalse());
+  EXPECT_THAT(time_manager.MustStop(kStart + milliseconds(7'996)), IsTrue());
+}
+
+}  // namespace
+}  // namespace follychess
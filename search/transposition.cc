@@ -17,25 +17,124 @@
 
 #include "search/transposition.h"
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
 #include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
+#include "absl/log/check.h"
 #include "engine/move.h"
 #include "engine/zobrist.h"
 #include "search/evaluation.h"
 
 namespace follychess {
 
-TranspositionTable::Metrics TranspositionTable::GetMetrics() const {
-  double hit_rate = 0;
-  if (probes_ != 0) {
-    hit_rate = static_cast<double>(hits_) / static_cast<double>(probes_);
+TranspositionTable::TranspositionTable(const std::size_t size_mb,
+                                       const int threads) {
+  Resize(size_mb, threads);
+}
+
+TranspositionTable::~TranspositionTable() { Deallocate(); }
+
+void TranspositionTable::Resize(const std::size_t size_mb, const int threads) {
+  DCHECK_GE(size_mb, 1);
+  Deallocate();
+  Allocate(std::bit_floor(size_mb * (1 << 20) / sizeof(Bucket)));
+  Clear(threads);
+}
+
+void TranspositionTable::Clear(const int threads) {
+  // Each thread zeroes a contiguous slice of the table. This also faults in
+  // the pages of a freshly allocated table.
+  const std::size_t num_threads =
+      std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(size_, 1));
+  const std::size_t slice_size = size_ / num_threads;
+
+  std::vector<std::jthread> workers;
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    Bucket* begin = table_ + i * slice_size;
+    Bucket* end = i + 1 == num_threads ? table_ + size_ : begin + slice_size;
+    workers.emplace_back(
+        [begin, end] { std::uninitialized_value_construct(begin, end); });
   }
+  workers.clear();
 
-  return {
-      .hits = hits_,
-      .misses = probes_ - hits_,
-      .hit_rate = hit_rate,
-  };
+  generation_ = 1;
+}
+
+void TranspositionTable::Allocate(const std::size_t size) {
+  const std::size_t bytes = size * sizeof(Bucket);
+  size_ = size;
+
+#if defined(__linux__)
+  void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory != MAP_FAILED) {
+#if defined(MADV_HUGEPAGE)
+    // This is only advice. If transparent huge pages are disabled, the table
+    // is simply backed by regular pages.
+    (void)madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+    table_ = static_cast<Bucket*>(memory);
+    mapped_ = true;
+    return;
+  }
+#endif
+
+  table_ = static_cast<Bucket*>(
+      ::operator new(bytes, std::align_val_t(alignof(Bucket))));
+  mapped_ = false;
+}
+
+void TranspositionTable::Deallocate() {
+  if (table_ == nullptr) {
+    return;
+  }
+
+  // Buckets are trivially destructible, so the memory can be released as is.
+  static_assert(std::is_trivially_destructible_v<Bucket>);
+  if (mapped_) {
+#if defined(__linux__)
+    munmap(table_, size_ * sizeof(Bucket));
+#endif
+  } else {
+    ::operator delete(table_, std::align_val_t(alignof(Bucket)));
+  }
+
+  table_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+}
+
+int TranspositionTable::GetHashFull() const {
+  // Like other engines, estimate the occupancy from the first thousand
+  // entries rather than scanning the whole table.
+  constexpr std::size_t kSampledBuckets = 1000 / kEntriesPerBucket;
+  const std::size_t buckets = std::min(size_, kSampledBuckets);
+  std::size_t current = 0;
+  for (std::size_t i = 0; i < buckets; ++i) {
+    for (const Entry& entry : table_[i].entries) {
+      if (entry.Load().generation == generation_) {
+        ++current;
+      }
+    }
+  }
+
+  if (buckets == 0) {
+    return 0;
+  }
+  return static_cast<int>(current * 1000 / (buckets * kEntriesPerBucket));
 }
 
 int TranspositionTable::NormalizeScore(const int score, const int ply) {
@@ -58,29 +157,70 @@ int TranspositionTable::DenormalizeScore(const int score, const int ply) {
   return score;
 }
 
-const TranspositionTable::Entry* TranspositionTable::GetEntry(
-    const ZobristKey key) const {
-  const Bucket& bucket = GetBucket(key);
+void TranspositionTable::NewSearch() {
+  generation_ = generation_ % kGenerationCycle + 1;
+}
 
-  // Always check deep_entry first. If it's a hit, it's guaranteed to be
-  // >= the depth of always_entry.
-  if (bucket.deep_entry.key == key) {
-    return &bucket.deep_entry;
-  }
+int TranspositionTable::GetAge(const int generation) const {
+  return (generation_ - generation + kGenerationCycle) % kGenerationCycle;
+}
 
-  if (bucket.always_entry.key == key) {
-    return &bucket.always_entry;
-  }
+std::uint64_t TranspositionTable::Entry::Pack(const EntryData& data) {
+  DCHECK_GE(data.score, std::numeric_limits<std::int16_t>::min());
+  DCHECK_LE(data.score, std::numeric_limits<std::int16_t>::max());
+  DCHECK_GE(data.remaining_depth, std::numeric_limits<std::int8_t>::min());
+  DCHECK_LE(data.remaining_depth, std::numeric_limits<std::int8_t>::max());
+  DCHECK_GE(data.generation, 1);
+  DCHECK_LE(data.generation, kGenerationCycle);
 
-  return nullptr;
+  return static_cast<std::uint64_t>(data.key_check) |
+         static_cast<std::uint64_t>(data.best_move.Data()) << 16 |
+         static_cast<std::uint64_t>(static_cast<std::uint16_t>(data.score))
+             << 32 |
+         static_cast<std::uint64_t>(
+             static_cast<std::uint8_t>(data.remaining_depth))
+             << 48 |
+         static_cast<std::uint64_t>(data.type) << 56 |
+         static_cast<std::uint64_t>(data.generation) << 58;
+}
+
+TranspositionTable::EntryData TranspositionTable::Entry::Unpack(
+    const std::uint64_t data) {
+  return {
+      .key_check = static_cast<std::uint16_t>(data),
+      .best_move = Move::FromData(static_cast<std::uint16_t>(data >> 16)),
+      .remaining_depth = static_cast<std::int8_t>(data >> 48),
+      .score = static_cast<std::int16_t>(data >> 32),
+      .type = static_cast<BoundType>((data >> 56) & 0b11),
+      .generation = static_cast<int>(data >> 58),
+  };
+}
+
+TranspositionTable::EntryData TranspositionTable::Entry::Load() const {
+  return Unpack(data_.load(std::memory_order_relaxed));
+}
+
+void TranspositionTable::Entry::Store(const EntryData& data) {
+  data_.store(Pack(data), std::memory_order_relaxed);
+}
+
+std::optional<TranspositionTable::EntryData> TranspositionTable::GetEntry(
+    const ZobristKey key) const {
+  const std::uint16_t key_check = GetKeyCheck(key);
+  for (const Entry& entry : GetBucket(key).entries) {
+    if (EntryData data = entry.Load();
+        !data.IsEmpty() && data.key_check == key_check) {
+      return data;
+    }
+  }
+  return std::nullopt;
 }
 
 std::optional<int> TranspositionTable::Probe(ZobristKey key,
                                              ProbeParams probe_params,
                                              Move* best_move) {
-  ++probes_;
-  const Entry* entry = GetEntry(key);
-  if (entry == nullptr) {
+  const std::optional<EntryData> entry = GetEntry(key);
+  if (!entry) {
     return std::nullopt;
   }
 
@@ -93,19 +233,16 @@ std::optional<int> TranspositionTable::Probe(ZobristKey key,
 
   switch (entry->type) {
     case BoundType::Exact:
-      ++hits_;
       return score;
 
     case BoundType::UpperBound:
       if (score <= probe_params.alpha) {
-        ++hits_;
         return probe_params.alpha;
       }
       break;
 
     case BoundType::LowerBound:
       if (score >= probe_params.beta) {
-        ++hits_;
         return probe_params.beta;
       }
       break;
@@ -117,20 +254,45 @@ std::optional<int> TranspositionTable::Probe(ZobristKey key,
 void TranspositionTable::Record(ZobristKey key, int score,
                                 RecordParams record_params, BoundType type,
                                 Move best_move) {
-  const Entry new_entry = {
-      .key = key,
+  EntryData new_entry = {
+      .key_check = GetKeyCheck(key),
       .best_move = best_move,
       .remaining_depth = record_params.depth,
       .score = NormalizeScore(score, record_params.ply),
       .type = type,
+      .generation = generation_,
   };
 
+  // Prefer, in order: the entry already holding this key, an empty entry, and
+  // finally the entry with the lowest remaining depth after accounting for
+  // its age.
   Bucket& bucket = GetBucket(key);
-  bucket.always_entry = new_entry;
-  if (!bucket.deep_entry.key ||
-      new_entry.remaining_depth >= bucket.deep_entry.remaining_depth) {
-    bucket.deep_entry = new_entry;
+  Entry* replace = nullptr;
+  int replace_value = std::numeric_limits<int>::max();
+  for (Entry& entry : bucket.entries) {
+    const EntryData data = entry.Load();
+    if (data.IsEmpty()) {
+      replace = &entry;
+      break;
+    }
+
+    if (data.key_check == new_entry.key_check) {
+      if (best_move == Move::NullMove()) {
+        new_entry.best_move = data.best_move;
+      }
+      replace = &entry;
+      break;
+    }
+
+    const int value =
+        data.remaining_depth - kAgeWeight * GetAge(data.generation);
+    if (value < replace_value) {
+      replace = &entry;
+      replace_value = value;
+    }
   }
+
+  replace->Store(new_entry);
 }
 
 }  // namespace follychess
@@ -18,10 +18,12 @@
 #ifndef FOLLYCHESS_SEARCH_TRANSPOSITION_H_
 #define FOLLYCHESS_SEARCH_TRANSPOSITION_H_
 
-#include <bit>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <utility>
-#include <vector>
 
 #include "engine/move.h"
 #include "engine/zobrist.h"
@@ -48,20 +50,26 @@ class TranspositionTable {
     int depth;
   };
 
-  struct Metrics {
-    std::int64_t hits;
-    std::int64_t misses;
-    double hit_rate;
-  };
-
   // Allocates the transposition table to fit within the specified memory limit.
   // The final number of entries is rounded down to the nearest power of two.
   // This enables fast bitwise indexing (`key & (size - 1)`) rather than slower
   // modulo arithmetic (`key % size`).
-  explicit TranspositionTable(std::size_t size_mb = 256)
-      : table_(std::bit_floor(size_mb * (1 << 20) / sizeof(Bucket))),
-        probes_(0),
-        hits_(0) {}
+  //
+  // `threads` is the number of threads used to zero the table. Touching the
+  // memory up front with multiple threads keeps page faults out of the search.
+  explicit TranspositionTable(std::size_t size_mb = 256, int threads = 1);
+
+  TranspositionTable(const TranspositionTable&) = delete;
+  TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+  ~TranspositionTable();
+
+  // Reallocates the table to fit within the specified memory limit. All
+  // entries are lost.
+  void Resize(std::size_t size_mb, int threads = 1);
+
+  // Removes all entries.
+  void Clear(int threads = 1);
 
   std::optional<int> Probe(ZobristKey key, ProbeParams probe_params,
                            Move* best_move);
@@ -69,49 +77,120 @@ class TranspositionTable {
   void Record(ZobristKey key, int score, RecordParams record_params,
               BoundType type, Move best_move);
 
-  [[nodiscard]] Metrics GetMetrics() const;
+  // Starts a new search generation. Entries from earlier generations are
+  // preferred for replacement, so that stale results from previous searches
+  // do not crowd out fresh ones.
+  void NewSearch();
+
+  // Hints the CPU to load the bucket for `key` into the cache, so that a later
+  // Probe() or Record() for the same key does not stall on memory.
+  void Prefetch(const ZobristKey key) const {
+    __builtin_prefetch(&GetBucket(key));
+  }
 
-  [[nodiscard]] std::size_t size() const { return table_.size(); }
+  // Returns the permille of sampled entries written by the current search, as
+  // reported by UCI's `hashfull`. Probes are counted by the search threads
+  // instead, which keeps the table free of counters shared by all threads.
+  [[nodiscard]] int GetHashFull() const;
+
+  [[nodiscard]] std::size_t size() const { return size_; }
 
  private:
   [[nodiscard]] static int NormalizeScore(int score, int ply);
 
   [[nodiscard]] static int DenormalizeScore(int score, int ply);
 
-  struct Entry {
-    ZobristKey key;
+  // The number of distinct generations. Generation zero is reserved to mark
+  // empty entries, so generations cycle through [1, kGenerationCycle].
+  static constexpr int kGenerationCycle = 63;
+
+  // When choosing an entry to evict, each generation of age counts as much as
+  // this many plies of remaining depth.
+  static constexpr int kAgeWeight = 8;
+
+  // The decoded contents of an entry.
+  struct EntryData {
+    // The upper 16 bits of the key. The lower bits are implied by the bucket
+    // index.
+    std::uint16_t key_check = 0;
     Move best_move;
-    int remaining_depth{0};
-    int score{0};
-    BoundType type{BoundType::Exact};
+    int remaining_depth = 0;
+    int score = 0;
+    BoundType type = BoundType::Exact;
+    int generation = 0;
+
+    [[nodiscard]] bool IsEmpty() const { return generation == 0; }
   };
 
-  static_assert(sizeof(Entry) == 24);
+  // An entry packed into a single 64-bit word. Since the word is read and
+  // written with a single atomic operation, search threads sharing the table
+  // can never observe an entry that is half-written by another thread.
+  class Entry {
+   public:
+    [[nodiscard]] EntryData Load() const;
+
+    void Store(const EntryData& data);
+
+   private:
+    // Layout of the word:
+    //
+    //   * Bits [0,  16): The key check.
+    //   * Bits [16, 32): The best move.
+    //   * Bits [32, 48): The normalized score.
+    //   * Bits [48, 56): The remaining depth.
+    //   * Bits [56, 58): The bound type.
+    //   * Bits [58, 64): The generation.
+    [[nodiscard]] static std::uint64_t Pack(const EntryData& data);
+
+    [[nodiscard]] static EntryData Unpack(std::uint64_t data);
+
+    std::atomic<std::uint64_t> data_ = 0;
+  };
 
-  struct Bucket {
-    // On a hash collision, this entry is always overwritten by the newest
-    // evaluation.
-    Entry always_entry;
+  static_assert(sizeof(Entry) == 8);
 
-    // On a hash collision, this entry is overwritten if and only if the new
-    // remaining_depth >= the stored remaining_depth.
-    Entry deep_entry;
+  static constexpr int kEntriesPerBucket = 8;
+
+  // Buckets are aligned to cache lines, so probing a bucket touches exactly
+  // one line of memory.
+  struct alignas(64) Bucket {
+    std::array<Entry, kEntriesPerBucket> entries;
   };
 
-  static_assert(sizeof(Bucket) == 48);
+  static_assert(sizeof(Bucket) == 64);
+
+  [[nodiscard]] static std::uint16_t GetKeyCheck(const ZobristKey key) {
+    return static_cast<std::uint16_t>(key.GetValue() >> 48);
+  }
+
+  // Returns how many searches ago the given generation was current.
+  [[nodiscard]] int GetAge(int generation) const;
 
   template <typename Self>
   [[nodiscard]] auto&& GetBucket(this Self&& self, const ZobristKey key) {
-    const std::size_t index = key.GetValue() & (self.table_.size() - 1);
-    return std::forward<Self>(self).table_[index];
+    const std::size_t index = key.GetValue() & (self.size_ - 1);
+    return std::forward_like<Self>(self.table_[index]);
   }
 
-  [[nodiscard]] const Entry* GetEntry(ZobristKey key) const;
+  [[nodiscard]] std::optional<EntryData> GetEntry(ZobristKey key) const;
+
+  // Allocates the memory for `size` buckets. On Linux, the memory is mapped
+  // directly and backed by transparent huge pages where the kernel allows it,
+  // which cuts down on TLB misses for large tables. Otherwise, or if mapping
+  // fails, the memory comes from the regular heap.
+  void Allocate(std::size_t size);
+
+  void Deallocate();
+
+  Bucket* table_ = nullptr;
+  std::size_t size_ = 0;
 
-  std::vector<Bucket> table_;
+  // Whether `table_` was allocated with `mmap`.
+  bool mapped_ = false;
 
-  std::int64_t probes_;
-  std::int64_t hits_;
+  // The generation of the current search. This is only modified between
+  // searches, so it is not atomic.
+  int generation_ = 1;
 };
 
 }  // namespace follychess
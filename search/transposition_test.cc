@@ -12,11 +12,16 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <thread>
+#include <vector>
+
 #include "engine/testing.h"
 
 namespace follychess {
 namespace {
 
+using ::testing::Each;
 using ::testing::Eq;
 using ::testing::Optional;
 using enum TranspositionTable::BoundType;
@@ -24,20 +29,53 @@ using enum TranspositionTable::BoundType;
 TEST(TranspositionTable, TableSize) {
   EXPECT_THAT(TranspositionTable(1).size(), Eq(1 << 14));
 
-  EXPECT_THAT(TranspositionTable(94).size(), Eq(1 << 20));
-  EXPECT_THAT(TranspositionTable(95).size(), Eq(1 << 20));
+  EXPECT_THAT(TranspositionTable(64).size(), Eq(1 << 20));
+  EXPECT_THAT(TranspositionTable(65).size(), Eq(1 << 20));
+  EXPECT_THAT(TranspositionTable(126).size(), Eq(1 << 20));
+  EXPECT_THAT(TranspositionTable(127).size(), Eq(1 << 20));
 
-  EXPECT_THAT(TranspositionTable(96).size(), Eq(1 << 21));
-  EXPECT_THAT(TranspositionTable(97).size(), Eq(1 << 21));
-  EXPECT_THAT(TranspositionTable(125).size(), Eq(1 << 21));
-  EXPECT_THAT(TranspositionTable(126).size(), Eq(1 << 21));
-  EXPECT_THAT(TranspositionTable(127).size(), Eq(1 << 21));
   EXPECT_THAT(TranspositionTable(128).size(), Eq(1 << 21));
+  EXPECT_THAT(TranspositionTable(129).size(), Eq(1 << 21));
   EXPECT_THAT(TranspositionTable(130).size(), Eq(1 << 21));
 
   EXPECT_THAT(TranspositionTable(256).size(), Eq(1 << 22));
 }
 
+TEST(TranspositionTable, Resize) {
+  TranspositionTable table(1);
+  table.Record(ZobristKey(123), 50, {.ply = 1, .depth = 5}, Exact,
+               MakeMove("e2e4"));
+
+  table.Resize(2, /*threads=*/3);
+  EXPECT_THAT(table.size(), Eq(1 << 15));
+
+  Move best_move;
+  EXPECT_THAT(table.Probe(ZobristKey(123),
+                          {.alpha = -100, .beta = 100, .ply = 1, .depth = 5},
+                          &best_move),
+              Eq(std::nullopt));
+  EXPECT_THAT(best_move, Eq(Move::NullMove()));
+}
+
+TEST(TranspositionTable, Clear) {
+  TranspositionTable table(1);
+  for (int i = 0; i < 1000; ++i) {
+    table.Record(ZobristKey(i), 50, {.ply = 1, .depth = 5}, Exact,
+                 MakeMove("e2e4"));
+  }
+
+  table.Clear(/*threads=*/4);
+
+  for (int i = 0; i < 1000; ++i) {
+    Move best_move;
+    EXPECT_THAT(table.Probe(ZobristKey(i),
+                            {.alpha = -100, .beta = 100, .ply = 1, .depth = 0},
+                            &best_move),
+                Eq(std::nullopt));
+  }
+  EXPECT_THAT(table.GetHashFull(), Eq(0));
+}
+
 TEST(TranspositionTable, EmptyTable) {
   TranspositionTable table;
   Move best_move;
@@ -48,9 +86,6 @@ TEST(TranspositionTable, EmptyTable) {
 
   EXPECT_THAT(score, Eq(std::nullopt));
   EXPECT_THAT(best_move, Eq(Move::NullMove()));
-  EXPECT_THAT(table.GetMetrics().hits, Eq(0));
-  EXPECT_THAT(table.GetMetrics().misses, Eq(1));
-  EXPECT_THAT(table.GetMetrics().hit_rate, Eq(0));
 }
 
 TEST(TranspositionTable, ExactScoreHit) {
@@ -66,9 +101,6 @@ TEST(TranspositionTable, ExactScoreHit) {
 
   EXPECT_THAT(score, Optional(50));
   EXPECT_THAT(best_move, Eq(MakeMove("e2e4")));
-  EXPECT_THAT(table.GetMetrics().hits, Eq(1));
-  EXPECT_THAT(table.GetMetrics().misses, Eq(0));
-  EXPECT_THAT(table.GetMetrics().hit_rate, Eq(1));
 }
 
 TEST(TranspositionTable, LowerBoundBetaCutoff) {
@@ -82,16 +114,11 @@ TEST(TranspositionTable, LowerBoundBetaCutoff) {
       ZobristKey(123), {.alpha = -100, .beta = 40, .ply = 1, .depth = 5},
       &best_move);
   EXPECT_THAT(score_cutoff, Optional(40));
-  EXPECT_THAT(table.GetMetrics().hits, Eq(1));
-  EXPECT_THAT(table.GetMetrics().misses, Eq(0));
 
   std::optional<int> score_no_cutoff = table.Probe(
       ZobristKey(123), {.alpha = -100, .beta = 60, .ply = 1, .depth = 5},
       &best_move);
   EXPECT_THAT(score_no_cutoff, Eq(std::nullopt));
-  EXPECT_THAT(table.GetMetrics().hits, Eq(1));
-  EXPECT_THAT(table.GetMetrics().misses, Eq(1));
-  EXPECT_THAT(table.GetMetrics().hit_rate, Eq(0.5));
 }
 
 TEST(TranspositionTable, UpperBoundAlphaCutoff) {
@@ -150,5 +177,151 @@ TEST(TranspositionTable, MateScoreNormalization) {
   EXPECT_THAT(neg_mate_probe, Optional(-19998));
 }
 
+// Returns a key that maps to the same bucket as every other key returned by
+// this function, but with a distinct key check.
+ZobristKey MakeCollidingKey(int i) {
+  return ZobristKey((static_cast<std::uint64_t>(i) << 48) | 7);
+}
+
+bool Contains(TranspositionTable& table, ZobristKey key) {
+  Move best_move;
+  return table
+      .Probe(key, {.alpha = -100, .beta = 100, .ply = 0, .depth = 0},
+             &best_move)
+      .has_value();
+}
+
+TEST(TranspositionTable, BucketHoldsMultipleEntries) {
+  TranspositionTable table(1);
+  for (int i = 0; i < 8; ++i) {
+    table.Record(MakeCollidingKey(i), i, {.ply = 0, .depth = 1}, Exact,
+                 MakeMove("e2e4"));
+  }
+
+  for (int i = 0; i < 8; ++i) {
+    Move best_move;
+    EXPECT_THAT(
+        table.Probe(MakeCollidingKey(i),
+                    {.alpha = -100, .beta = 100, .ply = 0, .depth = 1},
+                    &best_move),
+        Optional(i));
+  }
+}
+
+TEST(TranspositionTable, ReplacesShallowestEntry) {
+  TranspositionTable table(1);
+  for (int i = 0; i < 8; ++i) {
+    table.Record(MakeCollidingKey(i), 0, {.ply = 0, .depth = 8 - i}, Exact,
+                 MakeMove("e2e4"));
+  }
+
+  table.Record(MakeCollidingKey(8), 0, {.ply = 0, .depth = 1}, Exact,
+               MakeMove("e2e4"));
+
+  EXPECT_FALSE(Contains(table, MakeCollidingKey(7)));
+  for (int i : {0, 1, 2, 3, 4, 5, 6, 8}) {
+    EXPECT_TRUE(Contains(table, MakeCollidingKey(i))) << i;
+  }
+}
+
+TEST(TranspositionTable, PrefersReplacingStaleEntries) {
+  TranspositionTable table(1);
+  table.Record(MakeCollidingKey(0), 0, {.ply = 0, .depth = 12}, Exact,
+               MakeMove("e2e4"));
+
+  table.NewSearch();
+  for (int i = 1; i < 8; ++i) {
+    table.Record(MakeCollidingKey(i), 0, {.ply = 0, .depth = 6}, Exact,
+                 MakeMove("e2e4"));
+  }
+
+  // The entry from the previous search is deeper, but its age makes it the
+  // least valuable.
+  table.Record(MakeCollidingKey(8), 0, {.ply = 0, .depth = 6}, Exact,
+               MakeMove("e2e4"));
+
+  EXPECT_FALSE(Contains(table, MakeCollidingKey(0)));
+  for (int i = 1; i <= 8; ++i) {
+    EXPECT_TRUE(Contains(table, MakeCollidingKey(i))) << i;
+  }
+}
+
+TEST(TranspositionTable, OverwritingKeepsBestMove) {
+  TranspositionTable table;
+  Move best_move;
+
+  table.Record(ZobristKey(123), 10, {.ply = 0, .depth = 3}, Exact,
+               MakeMove("e2e4"));
+  table.Record(ZobristKey(123), 20, {.ply = 0, .depth = 4}, UpperBound,
+               Move::NullMove());
+
+  std::optional<int> score = table.Probe(
+      ZobristKey(123), {.alpha = 30, .beta = 100, .ply = 0, .depth = 4},
+      &best_move);
+
+  EXPECT_THAT(score, Optional(30));
+  EXPECT_THAT(best_move, Eq(MakeMove("e2e4")));
+}
+
+TEST(TranspositionTable, HashFull) {
+  TranspositionTable table(1);
+  EXPECT_THAT(table.GetHashFull(), Eq(0));
+
+  // Fill one entry in each of the sampled buckets.
+  for (int i = 0; i < 125; ++i) {
+    table.Record(ZobristKey(i), 0, {.ply = 0, .depth = 1}, Exact,
+                 MakeMove("e2e4"));
+  }
+  EXPECT_THAT(table.GetHashFull(), Eq(125));
+
+  // Entries from earlier searches are not counted.
+  table.NewSearch();
+  EXPECT_THAT(table.GetHashFull(), Eq(0));
+}
+
+TEST(TranspositionTable, ConcurrentAccessNeverReturnsTornEntries) {
+  // All keys share the same low bits, so every write lands in the same bucket
+  // and the threads race on the same entries.
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeys = 64;
+  constexpr int kNumIterations = 20'000;
+  TranspositionTable table(1);
+
+  auto make_key = [](int i) {
+    return ZobristKey((static_cast<std::uint64_t>(i) << 48) | 5);
+  };
+  auto make_move = [](int i) {
+    return Move::FromData(static_cast<std::uint16_t>(i * 97 + 1));
+  };
+
+  std::vector<int> torn_reads(kNumThreads, 0);
+  {
+    std::vector<std::jthread> threads;
+    for (int thread = 0; thread < kNumThreads; ++thread) {
+      threads.emplace_back([&, thread] {
+        for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+          const int i = (iteration * (thread + 1)) % kNumKeys;
+          table.Record(make_key(i), i, {.ply = 0, .depth = i % 8}, Exact,
+                       make_move(i));
+
+          const int j = (i + thread + 1) % kNumKeys;
+          Move best_move;
+          std::optional<int> score = table.Probe(
+              make_key(j), {.alpha = -100, .beta = 100, .ply = 0, .depth = 0},
+              &best_move);
+          if (best_move != Move::NullMove() && best_move != make_move(j)) {
+            ++torn_reads[thread];
+          }
+          if (score && *score != j) {
+            ++torn_reads[thread];
+          }
+        }
+      });
+    }
+  }
+
+  EXPECT_THAT(torn_reads, Each(0));
+}
+
 }  // namespace
 }  // namespace follychess
\ No newline at end of file